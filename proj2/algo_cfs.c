@@ -0,0 +1,129 @@
+#include "engine.h"
+#include "jobtree.h"
+
+// --- Completely Fair Scheduler ---
+// Runnable jobs sit in a red-black tree keyed by virtual runtime: CPU time
+// scaled by NICE0_WEIGHT / weight, so a heavier job's clock runs slower and
+// it gets a proportionally larger share. The leftmost (least served) job
+// runs next, for its share of SCHED_LATENCY but never less than the minimum
+// granularity.
+
+#define SCHED_LATENCY 6         // quanta in which every runnable job should run once
+#define MIN_GRANULARITY 1       // default shortest slice, quanta
+#define NICE0_WEIGHT 1024
+#define VRUNTIME_SHIFT 10       // vruntime units per quantum at NICE0_WEIGHT = 1 << 10
+
+// Priority 1-4 as nice -4, -1, 2, 5 (Linux weights): each level gets about
+// twice the CPU of the next
+static const int prio_weight[5] = { 0, 2501, 1277, 655, 335 };
+
+typedef struct {
+    JobTree tree;           // key = vruntime, kept for the running job too
+    int64_t min_vruntime;   // monotonic floor where new jobs are placed
+    long tree_weight;       // total weight of the jobs in the tree
+    int *picked_remaining;  // remaining time when each job was last picked
+    int granularity;
+} CfsState;
+
+static int weight_of(const JobState *proc) {
+    int pr = proc->priority;
+    if (pr < 1) pr = 1;
+    if (pr > 4) pr = 4;
+    return prio_weight[pr];
+}
+
+static void *cfs_init(SimEngine *e) {
+    CfsState *s = xcalloc(1, sizeof(CfsState));
+    jtree_init(&s->tree, e->count);
+    s->picked_remaining = xcalloc(e->count > 0 ? e->count : 1, sizeof(int));
+    s->granularity = e->min_granularity > 0 ? e->min_granularity : MIN_GRANULARITY;
+    return s;
+}
+
+static void cfs_destroy(void *st) {
+    CfsState *s = st;
+    jtree_free(&s->tree);
+    free(s->picked_remaining);
+    free(s);
+}
+
+static void *cfs_clone(SimEngine *e, const void *st) {
+    CfsState *s = xmemdup(st, sizeof(CfsState));
+    jtree_copy(&s->tree, &s->tree);
+    s->picked_remaining = xmemdup(s->picked_remaining, sizeof(int) * (e->count > 0 ? e->count : 1));
+    return s;
+}
+
+static void enqueue(SimEngine *e, CfsState *s, int job, int64_t vruntime) {
+    jtree_insert(&s->tree, job, vruntime);
+    s->tree_weight += weight_of(&e->st[job]);
+}
+
+// A new job starts level with the least served job, not at zero, so it
+// cannot monopolize the CPU to catch up
+static void cfs_arrive(SimEngine *e, void *st, int job) {
+    CfsState *s = st;
+    enqueue(e, s, job, s->min_vruntime);
+}
+
+// Charges the slice that just ended to the job's virtual clock
+static void cfs_requeue(SimEngine *e, void *st, int job) {
+    CfsState *s = st;
+    int ran = s->picked_remaining[job] - e->st[job].remaining_time;
+    int64_t vruntime = s->tree.key[job] + ((int64_t)ran << VRUNTIME_SHIFT) * NICE0_WEIGHT / weight_of(&e->st[job]);
+
+    int64_t floor = vruntime;
+    if (!jtree_empty(&s->tree) && s->tree.key[jtree_first(&s->tree)] < floor) floor = s->tree.key[jtree_first(&s->tree)];
+    if (floor > s->min_vruntime) s->min_vruntime = floor;
+
+    enqueue(e, s, job, vruntime);
+}
+
+static int cfs_pick(SimEngine *e, void *st) {
+    CfsState *s = st;
+    int job = jtree_first(&s->tree);
+    if (job < 0) return -1;
+    jtree_erase(&s->tree, job);
+    s->tree_weight -= weight_of(&e->st[job]);
+    s->picked_remaining[job] = e->st[job].remaining_time;
+    if (s->tree.key[job] > s->min_vruntime) s->min_vruntime = s->tree.key[job];
+    return job;
+}
+
+// The job's weighted share of the latency period
+static int cfs_quantum(SimEngine *e, void *st, int job) {
+    CfsState *s = st;
+    long w = weight_of(&e->st[job]);
+    long slice = SCHED_LATENCY * w / (s->tree_weight + w);
+    return slice > s->granularity ? (int)slice : s->granularity;
+}
+
+static bool cfs_contended(SimEngine *e, void *st, int job) { return !jtree_empty(&((CfsState *)st)->tree); }
+
+// A stolen job keeps its lag relative to the queue it came from
+static void cfs_adopt(SimEngine *e, void *st, void *from, int job) {
+    CfsState *s = st, *f = from;
+    s->tree.key[job] = f->tree.key[job] - f->min_vruntime + s->min_vruntime;
+    s->picked_remaining[job] = f->picked_remaining[job];
+}
+
+static const SchedPolicy CFS_POLICY = {
+    .name = "CFS",
+    // Charge the finished slice before placing arrivals at min_vruntime
+    .rank = { [EV_SLICE_END] = 0, [EV_TIMER] = 1, [EV_ARRIVAL] = 2 },
+    .init = cfs_init,
+    .destroy = cfs_destroy,
+    .arrive = cfs_arrive,
+    .requeue = cfs_requeue,
+    .pick = cfs_pick,
+    .quantum = cfs_quantum,
+    .contended = cfs_contended,
+    .adopt = cfs_adopt,
+    .clone = cfs_clone,
+};
+
+const SchedPolicy *policy_CFS(const SimParams *params) { return &CFS_POLICY; }
+
+void run_CFS(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log) {
+    engine_run(spec, st, count, params, &CFS_POLICY, log);
+}
@@ -1,34 +1,52 @@
-#include "scheduler.h"
-
-void run_FCFS(Process *p, int count) {
-    int time = 0;
-    
-    // Removed "&& time < TOTAL_QUANTA" from loop
-    for (int i = 0; i < count; i++) {
-
-        // CUTOFF: If time is up and this job hasn't started, stop.
-        if (time >= TOTAL_QUANTA) break;
-
-        // CPU waits until process arrives
-        if (time < p[i].arrival_time) {
-            time = p[i].arrival_time;
-        }
-
-        // Double check cutoff after idle
-        if (time >= TOTAL_QUANTA) break;
-
-        // Set start time once
-        if (p[i].start_time == -1) {
-            p[i].start_time = time;
-        }
-
-        // Run process to completion (Removed "&& time < TOTAL_QUANTA")
-        while (p[i].remaining_time > 0) {
-            if(time < TOTAL_QUANTA) p[i].history[time] = true; // Visuals only
-            p[i].remaining_time--;
-            time++;
-        }
-
-        p[i].finish_time = time;
-    }
-}
\ No newline at end of file
+#include "engine.h"
+
+// Every job is queued exactly once, so a flat array of 'count' slots suffices
+typedef struct {
+    int *q;
+    int head, tail;
+} FcfsState;
+
+static void *fcfs_init(SimEngine *e) {
+    FcfsState *s = xcalloc(1, sizeof(FcfsState));
+    s->q = xmalloc(sizeof(int) * (e->count > 0 ? e->count : 1));
+    return s;
+}
+
+static void fcfs_destroy(void *st) {
+    FcfsState *s = st;
+    free(s->q);
+    free(s);
+}
+
+static void *fcfs_clone(SimEngine *e, const void *st) {
+    FcfsState *s = xmemdup(st, sizeof(FcfsState));
+    s->q = xmemdup(s->q, sizeof(int) * (e->count > 0 ? e->count : 1));
+    return s;
+}
+
+static void fcfs_arrive(SimEngine *e, void *st, int job) {
+    FcfsState *s = st;
+    s->q[s->tail++] = job;
+}
+
+static int fcfs_pick(SimEngine *e, void *st) {
+    FcfsState *s = st;
+    if (s->head == s->tail) return -1;
+    return s->q[s->head++];
+}
+
+static const SchedPolicy FCFS_POLICY = {
+    .name = "FCFS",
+    .init = fcfs_init,
+    .destroy = fcfs_destroy,
+    .arrive = fcfs_arrive,
+    .pick = fcfs_pick,
+    .clone = fcfs_clone,
+    // Non-preemptive: no quantum, jobs never come back through requeue
+};
+
+const SchedPolicy *policy_FCFS(const SimParams *params) { return &FCFS_POLICY; }
+
+void run_FCFS(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log) {
+    engine_run(spec, st, count, params, &FCFS_POLICY, log);
+}
@@ -1,260 +1,353 @@
-#include "scheduler.h"
+#include "engine.h"
+#include "jobtable.h"
+#include "runqueue.h"
 
 #define NUM_QUEUES 4
-#define AGING_LIMIT 5
+
+// --- HPF Preemptive ---
+// Aging is lazy: besides its FIFO run queue, every agable level keeps a
+// min-heap of (time joined the level, queue handle). A sweep pops the heap
+// only while its oldest entry is due, so an instant where nobody ages costs
+// one peek per level instead of a walk over every waiting job. Entries are
+// never removed eagerly; one whose job left the slot it names is skipped.
+
+typedef struct {
+    int entered;
+    unsigned handle;
+    int job;
+} AgeEntry;
+
+typedef struct {
+    AgeEntry *a;
+    int size, cap;
+} AgeHeap;
 
 typedef struct {
-    Process *q[MAX_JOBS];
-    int front, rear; // rear acts as 'count' in shifting implementation
-} Queue;
-
-// FIX: Simple check to ensure we don't go out of bounds
-static void enqueue(Queue *q, Process *p) {
-    if (q->rear < MAX_JOBS) {
-        q->q[q->rear++] = p;
-    } else {
-        // With shifting dequeue, this is unlikely unless we have >100 active jobs
-        fprintf(stderr, "Queue overflow\n");
-        exit(1);
+    RunQueue queues[NUM_QUEUES];
+    AgeHeap aging[NUM_QUEUES];  // level 0 never ages
+    int *entered;     // time each job joined its current queue level
+    unsigned *due;    // scratch: queue positions (from head) due at one level
+    int due_cap;
+} HpfPreState;
+
+static bool age_before(const AgeEntry *x, const AgeEntry *y) {
+    if (x->entered != y->entered) return x->entered < y->entered;
+    return x->handle < y->handle;
+}
+
+static void age_push(AgeHeap *h, AgeEntry ent) {
+    if (h->size == h->cap) {
+        h->cap = h->cap ? h->cap * 2 : 16;
+        h->a = realloc(h->a, h->cap * sizeof(AgeEntry));
+        if (!h->a) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
     }
+    int i = h->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!age_before(&ent, &h->a[parent])) break;
+        h->a[i] = h->a[parent];
+        i = parent;
+    }
+    h->a[i] = ent;
 }
 
-// FIX: Shifting Dequeue
-// Moves all elements down so 'rear' doesn't grow forever.
-// Keeps the array contiguous [0..rear], so your aging loop works safely.
-static Process *dequeue(Queue *q) {
-    if (q->front == q->rear) return NULL; // Empty
+static AgeEntry age_pop(AgeHeap *h) {
+    AgeEntry top = h->a[0];
+    AgeEntry last = h->a[--h->size];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= h->size) break;
+        if (child + 1 < h->size && age_before(&h->a[child + 1], &h->a[child])) child++;
+        if (!age_before(&h->a[child], &last)) break;
+        h->a[i] = h->a[child];
+        i = child;
+    }
+    if (h->size > 0) h->a[i] = last;
+    return top;
+}
 
-    Process *p = q->q[0]; // Always take from 0
+static void *hpf_pre_init(SimEngine *e) {
+    HpfPreState *s = xcalloc(1, sizeof(HpfPreState));
+    int n = e->count > 0 ? e->count : 1;
+    for (int pr = 0; pr < NUM_QUEUES; pr++) rq_init(&s->queues[pr], 0);
+    s->entered = xcalloc(n, sizeof(int));
+    return s;
+}
 
-    // Shift everyone left
-    for (int i = 0; i < q->rear - 1; i++) {
-        q->q[i] = q->q[i + 1];
+static void hpf_pre_destroy(void *st) {
+    HpfPreState *s = st;
+    for (int pr = 0; pr < NUM_QUEUES; pr++) {
+        rq_free(&s->queues[pr]);
+        free(s->aging[pr].a);
     }
-    
-    q->rear--; // Decrease count
-    // q->front stays 0
-    return p;
+    free(s->entered);
+    free(s->due);
+    free(s);
 }
 
-static bool is_empty(Queue *q) { return q->rear == 0; }
-
-void run_HPF_Preemptive(Process *p, int count) {
-    Queue queues[NUM_QUEUES] = {0};
-    int time = 0, finished = 0;
-    int wait_age[MAX_JOBS] = {0};
-
-    // Initialize processes
-    for (int i = 0; i < count; i++) {
-        p[i].remaining_time = p[i].run_time;
-        p[i].start_time = -1;
-        // Safety: Ensure priority is 1-4
-        if(p[i].priority < 1) p[i].priority = 1;
-        if(p[i].priority > 4) p[i].priority = 4;
-        
-        for (int t = 0; t < TOTAL_QUANTA; t++)
-            p[i].history[t] = false;
+static void *hpf_pre_clone(SimEngine *e, const void *st) {
+    HpfPreState *s = xmemdup(st, sizeof(HpfPreState));
+    for (int pr = 0; pr < NUM_QUEUES; pr++) {
+        rq_copy(&s->queues[pr], &s->queues[pr]);
+        s->aging[pr].a = xmemdup(s->aging[pr].a, sizeof(AgeEntry) * s->aging[pr].cap);
     }
+    s->entered = xmemdup(s->entered, sizeof(int) * (e->count > 0 ? e->count : 1));
+    s->due = NULL;
+    s->due_cap = 0;
+    return s;
+}
 
-    // FIX: Removed "time < TOTAL_QUANTA" (Run to completion)
-    while (finished < count) {
+// Priority 1-4 maps to Index 0-3; 'entered' must already be set
+static void enqueue(SimEngine *e, HpfPreState *s, int job) {
+    int pr = e->st[job].priority - 1;
+    unsigned handle = rq_push(&s->queues[pr], job);
+    if (pr > 0) age_push(&s->aging[pr], (AgeEntry){ s->entered[job], handle, job });
+}
 
-        // Add arriving processes
-        for (int i = 0; i < count; i++) {
-            if (p[i].arrival_time == time) {
-                // FIX: Priority 1-4 maps to Index 0-3
-                enqueue(&queues[p[i].priority - 1], &p[i]);
-            }
-        }
+// True while 'ent' still names a live queue entry for its job
+static bool age_live(const HpfPreState *s, const RunQueue *q, const AgeEntry *ent) {
+    return ent->handle - q->head < q->tail - q->head && rq_at(q, ent->handle) == ent->job &&
+           s->entered[ent->job] == ent->entered;
+}
 
-        Process *current = NULL;
-        int active_q = -1;
-
-        // Pick highest priority ready process
-        for (int pr = 0; pr < NUM_QUEUES; pr++) {
-            if (!is_empty(&queues[pr])) {
-                // Peek first (don't remove yet until we know it's valid)
-                current = queues[pr].q[0]; 
-                
-                // FIX: Start Cutoff Rule
-                // If it's new and time >= 100, we must drop it.
-                if (current->start_time == -1 && time >= TOTAL_QUANTA) {
-                    dequeue(&queues[pr]); // Remove and discard
-                    current = NULL; // Force loop to continue looking or idle
-                    
-                    // Note: In strict logic, we might need to check the next job immediately.
-                    // But simpler to just break and let the next tick handle it if busy.
-                    // Check if we exhausted this queue?
-                    if (is_empty(&queues[pr])) continue;
-                    else {
-                        // If there are more jobs, we should check them now?
-                        // For simplicity, we just decrement pr to retry this queue
-                        pr--; 
-                        continue;
-                    }
-                }
-                
-                // If valid, actually remove it
-                current = dequeue(&queues[pr]);
-                active_q = pr;
-                break;
-            }
-        }
+static void hpf_pre_arrive(SimEngine *e, void *st, int job) {
+    HpfPreState *s = st;
+    JobState *proc = &e->st[job];
 
-        if (current) {
-            if (current->start_time == -1) {
-                current->start_time = time;
-                current->response_time = time - current->arrival_time;
-            }
+    // Safety: Ensure priority is 1-4
+    if (proc->priority < 1) proc->priority = 1;
+    if (proc->priority > 4) proc->priority = 4;
 
-            if (time < TOTAL_QUANTA)
-                current->history[time] = true;
+    s->entered[job] = e->now;
+    enqueue(e, s, job);
+    if (proc->priority > 1) engine_schedule_timer(e, e->now + e->aging_limit, job);
+}
 
-            current->remaining_time--;
+static void hpf_pre_requeue(SimEngine *e, void *st, int job) {
+    enqueue(e, st, job);
+}
 
-            // Preempt or finish
-            if (current->remaining_time == 0) {
-                current->finish_time = time + 1;
-                finished++;
-            } else {
-                // FIX: Re-enqueue to same priority index
-                enqueue(&queues[current->priority - 1], current);
-            }
-        } else {
-            // Idle: If we are past 100 and idle, we are done
-            if (time >= TOTAL_QUANTA) break;
-        }
+static int hpf_pre_pick(SimEngine *e, void *st) {
+    HpfPreState *s = st;
+    for (int pr = 0; pr < NUM_QUEUES; pr++) {
+        if (!rq_empty(&s->queues[pr])) return rq_pop(&s->queues[pr]);
+    }
+    return -1;
+}
 
-        // Aging (Your logic preserved, works with Shifting Queue)
-        for (int pr = 1; pr < NUM_QUEUES; pr++) {
-            // Since front is always 0 in shifting queue, iterate 0 to rear
-            for (int i = 0; i < queues[pr].rear; i++) {
-                Process *proc = queues[pr].q[i];
-                if (!proc) continue;
-
-                int idx = proc->id - 1; 
-                wait_age[idx]++;
-                if (wait_age[idx] >= AGING_LIMIT) {
-                    // Reduce Priority (e.g. 2 -> 1)
-                    if (proc->priority > 1) proc->priority--;
-                    
-                    // Move to higher priority queue
-                    enqueue(&queues[pr - 1], proc);
-                    wait_age[idx] = 0;
-                    
-                    // Remove from current queue by marking NULL? 
-                    // No, shifting queue doesn't support holes easily.
-                    // We must manually shift this one out or rebuild.
-                    // SIMPLE FIX: Just mark NULL here and filter in dequeue?
-                    // OR: Since this is specific, let's just accept the NULL slot logic
-                    // you had, but updated for the new enqueue.
-                    // Actually, 'enqueue' adds to rear. We can just shift the array here manually.
-                    for(int k=i; k < queues[pr].rear - 1; k++) {
-                        queues[pr].q[k] = queues[pr].q[k+1];
-                    }
-                    queues[pr].rear--;
-                    i--; // Decrement i so we don't skip the next one
+static int hpf_pre_quantum(SimEngine *e, void *st, int job) { return 1; }
+
+// Round robin within a level: only jobs at the same level compete
+static bool hpf_pre_contended(SimEngine *e, void *st, int job) {
+    HpfPreState *s = st;
+    return !rq_empty(&s->queues[e->st[job].priority - 1]);
+}
+
+static int cmp_unsigned(const void *x, const void *y) {
+    unsigned a = *(const unsigned *)x, b = *(const unsigned *)y;
+    return (a > b) - (a < b);
+}
+
+// Aging: a job that has sat aging_limit quanta at one level moves up one level.
+// Jobs are promoted in queue order, lower levels first, as the per-tick sweep did.
+static void hpf_pre_age(SimEngine *e, void *st, int job) {
+    HpfPreState *s = st;
+
+    for (int pr = 1; pr < NUM_QUEUES; pr++) {
+        RunQueue *q = &s->queues[pr];
+        AgeHeap *h = &s->aging[pr];
+
+        // Everything that joined this level aging_limit or more quanta ago
+        unsigned base = q->head;
+        int n = 0;
+        while (h->size > 0 && e->now - h->a[0].entered >= e->aging_limit) {
+            AgeEntry ent = age_pop(h);
+            if (!age_live(s, q, &ent)) continue;
+            if (n == s->due_cap) {
+                s->due_cap = s->due_cap ? s->due_cap * 2 : 16;
+                s->due = realloc(s->due, s->due_cap * sizeof(unsigned));
+                if (!s->due) {
+                    fprintf(stderr, "Out of memory\n");
+                    exit(1);
                 }
             }
+            s->due[n++] = ent.handle - base;
+        }
+        if (n == 0) continue;
+        if (n > 1) qsort(s->due, n, sizeof(unsigned), cmp_unsigned);
+
+        for (int i = 0; i < n; i++) {
+            if (i > 0 && s->due[i] == s->due[i - 1]) continue; // duplicate entry
+            unsigned handle = base + s->due[i];
+            int idx = rq_at(q, handle);
+
+            // Reduce Priority (e.g. 2 -> 1) and move to the higher priority queue.
+            // The handle takes the entry out of the lower queue in O(1).
+            rq_remove(q, handle);
+            e->st[idx].priority--;
+            s->entered[idx] = e->now;
+            enqueue(e, s, idx);
+            if (pr - 1 > 0) engine_schedule_timer(e, e->now + e->aging_limit, idx);
         }
-
-        time++;
     }
+}
+
+// A stolen job keeps aging from when it joined its level on the old CPU
+static void hpf_pre_adopt(SimEngine *e, void *st, void *from, int job) {
+    ((HpfPreState *)st)->entered[job] = ((HpfPreState *)from)->entered[job];
+}
 
-    // Compute stats
-    for (int i = 0; i < count; i++) {
-        if(p[i].finish_time > 0) {
-            p[i].turnaround_time = p[i].finish_time - p[i].arrival_time;
-            p[i].waiting_time = p[i].turnaround_time - p[i].run_time;
-            p[i].response_time = p[i].start_time - p[i].arrival_time;
+static const SchedPolicy HPF_PRE_POLICY = {
+    .name = "HPF-Pre",
+    // At a quantum boundary: requeue the preempted job, then age, then admit arrivals
+    .rank = { [EV_SLICE_END] = 0, [EV_TIMER] = 1, [EV_ARRIVAL] = 2 },
+    .init = hpf_pre_init,
+    .destroy = hpf_pre_destroy,
+    .arrive = hpf_pre_arrive,
+    .requeue = hpf_pre_requeue,
+    .pick = hpf_pre_pick,
+    .quantum = hpf_pre_quantum,
+    .contended = hpf_pre_contended,
+    .timer = hpf_pre_age,
+    .adopt = hpf_pre_adopt,
+    .clone = hpf_pre_clone,
+};
+
+const SchedPolicy *policy_HPF_Preemptive(const SimParams *params) { return &HPF_PRE_POLICY; }
+
+void run_HPF_Preemptive(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log) {
+    engine_run(spec, st, count, params, &HPF_PRE_POLICY, log);
+}
+
+// --- HPF Non-Preemptive ---
+
+// A waiting job is aged once per quantum starting with its arrival quantum,
+// so after waiting w quanta it has been promoted (w + 1) / aging_limit times.
+// That is a function of its arrival alone, so nothing is stored or scheduled
+// per tick: jobs wait in one FIFO per initial level, and as a FIFO's head
+// arrived first it is also its most aged job. Picking compares the heads by
+// (aged priority, arrival, id), the order a heap over every job would give.
+
+typedef struct {
+    RunQueue levels[NUM_QUEUES];
+} HpfNpState;
+
+static int aged_priority(const SimEngine *e, int job, int level) {
+    int prio = level + 1 - (e->now - e->spec[job].arrival_time + 1) / e->aging_limit;
+    return prio > 1 ? prio : 1;
+}
+
+static void *hpf_np_init(SimEngine *e) {
+    HpfNpState *s = xcalloc(1, sizeof(HpfNpState));
+    for (int lv = 0; lv < NUM_QUEUES; lv++) rq_init(&s->levels[lv], 0);
+    return s;
+}
+
+static void hpf_np_destroy(void *st) {
+    HpfNpState *s = st;
+    for (int lv = 0; lv < NUM_QUEUES; lv++) rq_free(&s->levels[lv]);
+    free(s);
+}
+
+static void *hpf_np_clone(SimEngine *e, const void *st) {
+    HpfNpState *s = xmemdup(st, sizeof(HpfNpState));
+    for (int lv = 0; lv < NUM_QUEUES; lv++) rq_copy(&s->levels[lv], &s->levels[lv]);
+    return s;
+}
+
+static void hpf_np_arrive(SimEngine *e, void *st, int job) {
+    JobState *proc = &e->st[job];
+    // Safety: Ensure priority is 1-4
+    if (proc->priority < 1) proc->priority = 1;
+    if (proc->priority > 4) proc->priority = 4;
+    rq_push(&((HpfNpState *)st)->levels[proc->priority - 1], job);
+}
+
+static int hpf_np_pick(SimEngine *e, void *st) {
+    HpfNpState *s = st;
+    int best = -1, best_lv = 0, best_prio = 0;
+    for (int lv = 0; lv < NUM_QUEUES; lv++) {
+        int job = rq_peek(&s->levels[lv]);
+        if (job < 0) continue;
+        int prio = aged_priority(e, job, lv);
+        if (best >= 0) {
+            const JobSpec *a = &e->spec[job], *b = &e->spec[best];
+            if (prio > best_prio) continue;
+            if (prio == best_prio && (a->arrival_time > b->arrival_time ||
+                                      (a->arrival_time == b->arrival_time && a->id > b->id))) continue;
         }
+        best = job;
+        best_lv = lv;
+        best_prio = prio;
     }
+    if (best < 0) return -1;
+    rq_pop(&s->levels[best_lv]);
+    e->st[best].priority = best_prio;
+    return best;
 }
 
-#include <limits.h>
-
-void run_HPF_NonPreemptive(Process *p, int count)
-{
-    int time = 0;
-    int completed = 0;
-    Process *current = NULL;
-    int wait_at_level[MAX_JOBS] = {0};
-
-    for (int i = 0; i < count; i++) {
-        p[i].remaining_time = p[i].run_time;
-        p[i].start_time = -1;
-        p[i].finish_time = 0;
-        p[i].waiting_time = 0;
-        p[i].turnaround_time = 0;
-        p[i].response_time = 0;
-        for (int t = 0; t < TOTAL_QUANTA; t++) p[i].history[t] = false;
-    }
+static const SchedPolicy HPF_NP_POLICY = {
+    .name = "HPF-NP",
+    .init = hpf_np_init,
+    .destroy = hpf_np_destroy,
+    .arrive = hpf_np_arrive,
+    .pick = hpf_np_pick,
+    .clone = hpf_np_clone,
+};
+
+// Scan variant: the table's key column is the aged priority
+static void *hpf_np_scan_init(SimEngine *e) {
+    JobTable *t = xmalloc(sizeof(JobTable));
+    jtable_init(t, e->count);
+    return t;
+}
 
-    // FIX: Removed "time < TOTAL_QUANTA"
-    while (completed < count) {
-        
-        // Aging Logic
-        for (int i = 0; i < count; i++) {
-            if (p[i].arrival_time <= time && p[i].remaining_time > 0) {
-                if (current != &p[i]) {
-                    wait_at_level[i]++;
-                    if (wait_at_level[i] >= 5) {
-                        if (p[i].priority > 1) p[i].priority--; // FIX: 1 is min
-                        wait_at_level[i] = 0;
-                    }
-                } else {
-                    wait_at_level[i] = 0;
-                }
-            }
-        }
+static void hpf_np_scan_destroy(void *st) {
+    jtable_free(st);
+    free(st);
+}
 
-        if (current == NULL) {
-            int best = -1;
-            int best_priority = INT_MAX;
-            int best_arrival = INT_MAX;
-            int best_id = INT_MAX;
-
-            for (int i = 0; i < count; i++) {
-                if (p[i].arrival_time <= time && p[i].remaining_time > 0) {
-                    
-                    // FIX: Start Cutoff Rule
-                    if (p[i].start_time == -1 && time >= TOTAL_QUANTA) continue;
-
-                    if (p[i].priority < best_priority ||
-                       (p[i].priority == best_priority && p[i].arrival_time < best_arrival) ||
-                       (p[i].priority == best_priority && p[i].arrival_time == best_arrival && p[i].id < best_id)) {
-
-                        best = i;
-                        best_priority = p[i].priority;
-                        best_arrival = p[i].arrival_time;
-                        best_id = p[i].id;
-                    }
-                }
-            }
+static void *hpf_np_scan_clone(SimEngine *e, const void *st) {
+    JobTable *t = xmalloc(sizeof(JobTable));
+    jtable_copy(t, st, e->count);
+    return t;
+}
 
-            if (best != -1) {
-                current = &p[best];
-                if (current->start_time == -1) {
-                    current->start_time = time;
-                    current->response_time = time - current->arrival_time;
-                }
-            } else {
-                // If idle and past 100, quit
-                if (time >= TOTAL_QUANTA) break;
-            }
-        }
+static void hpf_np_scan_arrive(SimEngine *e, void *st, int job) {
+    jtable_put(st, job, e->st[job].priority);
+    if (e->st[job].start_time >= 0) ((JobTable *)st)->unstarted[job] = 0; // re-arrival after engine_switch
+    if (e->st[job].priority > 1) engine_schedule_timer(e, e->now + e->aging_limit - 1, job);
+}
 
-        if (current != NULL) {
-            if (time < TOTAL_QUANTA) current->history[time] = true;
-            current->remaining_time--;
+static void hpf_np_scan_age(SimEngine *e, void *st, int job) {
+    if (!jtable_contains(st, job)) return; // already picked or dropped
 
-            if (current->remaining_time == 0) {
-                current->finish_time = time + 1;
-                completed++;
-                current = NULL;
-            }
-        }
+    JobState *proc = &e->st[job];
+    if (proc->priority > 1) proc->priority--;
+    jtable_put(st, job, proc->priority);
+    if (proc->priority > 1) engine_schedule_timer(e, e->now + e->aging_limit, job);
+}
 
-        time++;
-    }
-}
\ No newline at end of file
+static int hpf_np_scan_pick(SimEngine *e, void *st) { return jtable_pop(st, e->now >= e->cutoff); }
+
+static const SchedPolicy HPF_NP_SCAN_POLICY = {
+    .name = "HPF-NP",
+    .init = hpf_np_scan_init,
+    .destroy = hpf_np_scan_destroy,
+    .arrive = hpf_np_scan_arrive,
+    .pick = hpf_np_scan_pick,
+    .timer = hpf_np_scan_age,
+    .clone = hpf_np_scan_clone,
+};
+
+const SchedPolicy *policy_HPF_NonPreemptive(const SimParams *params) {
+    return params->scan ? &HPF_NP_SCAN_POLICY : &HPF_NP_POLICY;
+}
+
+void run_HPF_NonPreemptive(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log) {
+    engine_run(spec, st, count, params, policy_HPF_NonPreemptive(params), log);
+}
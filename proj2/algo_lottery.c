@@ -0,0 +1,156 @@
+#include "engine.h"
+#include "jobtree.h"
+#include "tickets.h"
+
+// --- Proportional Share ---
+// Priority 1-4 buys 8, 4, 2 and 1 shares of the CPU. Lottery draws a random
+// ticket every quantum, so a job's share holds on average; Stride hands out
+// the same shares deterministically.
+
+#define QUANTUM 1
+#define STRIDE1 (1 << 20)   // pass units one quantum costs a job holding one ticket
+
+static const int prio_tickets[5] = { 0, 800, 400, 200, 100 };
+
+static int tickets_of(JobState *proc) {
+    // Safety: Ensure priority is 1-4
+    if (proc->priority < 1) proc->priority = 1;
+    if (proc->priority > 4) proc->priority = 4;
+    return prio_tickets[proc->priority];
+}
+
+static int ps_quantum(SimEngine *e, void *st, int job) { return QUANTUM; }
+
+// --- Lottery ---
+
+static void *lottery_init(SimEngine *e) {
+    TicketPool *t = xmalloc(sizeof(TicketPool));
+    tpool_init(t, e->count / e->ncpu);
+    return t;
+}
+
+static void lottery_destroy(void *st) {
+    tpool_free(st);
+    free(st);
+}
+
+static void *lottery_clone(SimEngine *e, const void *st) {
+    TicketPool *t = xmalloc(sizeof(TicketPool));
+    tpool_copy(t, st);
+    return t;
+}
+
+static void lottery_push(SimEngine *e, void *st, int job) { tpool_add(st, job, tickets_of(&e->st[job])); }
+
+// Draws from the engine's stream, so a seed always gives the same schedule
+static int lottery_pick(SimEngine *e, void *st) {
+    TicketPool *t = st;
+    if (tpool_empty(t)) return -1;
+    return tpool_take(t, (int64_t)(rng_next(&e->rng) % (uint64_t)t->total));
+}
+
+static bool lottery_contended(SimEngine *e, void *st, int job) { return !tpool_empty(st); }
+
+static const SchedPolicy LOTTERY_POLICY = {
+    .name = "Lottery",
+    .rank = { [EV_SLICE_END] = 0, [EV_TIMER] = 1, [EV_ARRIVAL] = 2 },
+    .init = lottery_init,
+    .destroy = lottery_destroy,
+    .arrive = lottery_push,
+    .requeue = lottery_push,
+    .pick = lottery_pick,
+    .quantum = ps_quantum,
+    .contended = lottery_contended,
+    .clone = lottery_clone,
+};
+
+const SchedPolicy *policy_Lottery(const SimParams *params) { return &LOTTERY_POLICY; }
+
+void run_Lottery(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log) {
+    engine_run(spec, st, count, params, &LOTTERY_POLICY, log);
+}
+
+// --- Stride ---
+// Every job has a pass value that advances by its stride, STRIDE1 / tickets,
+// for each quantum it runs; the lowest pass runs next. Ties go to the lower
+// job index.
+
+typedef struct {
+    JobTree tree;           // key = pass
+    int64_t global_pass;    // pass of the last job picked, where arrivals start
+    int *picked_remaining;  // remaining time when each job was last picked
+} StrideState;
+
+static void *stride_init(SimEngine *e) {
+    StrideState *s = xcalloc(1, sizeof(StrideState));
+    jtree_init(&s->tree, e->count);
+    s->picked_remaining = xcalloc(e->count > 0 ? e->count : 1, sizeof(int));
+    return s;
+}
+
+static void stride_destroy(void *st) {
+    StrideState *s = st;
+    jtree_free(&s->tree);
+    free(s->picked_remaining);
+    free(s);
+}
+
+static void *stride_clone(SimEngine *e, const void *st) {
+    StrideState *s = xmemdup(st, sizeof(StrideState));
+    jtree_copy(&s->tree, &s->tree);
+    s->picked_remaining = xmemdup(s->picked_remaining, sizeof(int) * (e->count > 0 ? e->count : 1));
+    return s;
+}
+
+// A new job is one stride behind the current pass, as if it had just run
+static void stride_arrive(SimEngine *e, void *st, int job) {
+    StrideState *s = st;
+    jtree_insert(&s->tree, job, s->global_pass + STRIDE1 / tickets_of(&e->st[job]));
+}
+
+// Charges every quantum of the slice that just ended (it may have been stretched)
+static void stride_requeue(SimEngine *e, void *st, int job) {
+    StrideState *s = st;
+    int ran = s->picked_remaining[job] - e->st[job].remaining_time;
+    jtree_insert(&s->tree, job, s->tree.key[job] + (int64_t)ran * (STRIDE1 / tickets_of(&e->st[job])));
+}
+
+static int stride_pick(SimEngine *e, void *st) {
+    StrideState *s = st;
+    int job = jtree_first(&s->tree);
+    if (job < 0) return -1;
+    jtree_erase(&s->tree, job);
+    s->picked_remaining[job] = e->st[job].remaining_time;
+    if (s->tree.key[job] > s->global_pass) s->global_pass = s->tree.key[job];
+    return job;
+}
+
+static bool stride_contended(SimEngine *e, void *st, int job) { return !jtree_empty(&((StrideState *)st)->tree); }
+
+// A stolen job keeps its lead or lag relative to the CPU it came from
+static void stride_adopt(SimEngine *e, void *st, void *from, int job) {
+    StrideState *s = st, *f = from;
+    s->tree.key[job] = f->tree.key[job] - f->global_pass + s->global_pass;
+    s->picked_remaining[job] = f->picked_remaining[job];
+}
+
+static const SchedPolicy STRIDE_POLICY = {
+    .name = "Stride",
+    // Charge the finished slice before placing arrivals at the global pass
+    .rank = { [EV_SLICE_END] = 0, [EV_TIMER] = 1, [EV_ARRIVAL] = 2 },
+    .init = stride_init,
+    .destroy = stride_destroy,
+    .arrive = stride_arrive,
+    .requeue = stride_requeue,
+    .pick = stride_pick,
+    .quantum = ps_quantum,
+    .contended = stride_contended,
+    .adopt = stride_adopt,
+    .clone = stride_clone,
+};
+
+const SchedPolicy *policy_Stride(const SimParams *params) { return &STRIDE_POLICY; }
+
+void run_Stride(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log) {
+    engine_run(spec, st, count, params, &STRIDE_POLICY, log);
+}
@@ -1,81 +1,47 @@
-#include "scheduler.h"
+#include "engine.h"
+#include "runqueue.h"
 
-#define QUANTUM 1
-
-// FIX: tail acts as 'count'. 'head' is unused (always 0).
-typedef struct { int items[100]; int head, tail; } Queue;
-void init_q(Queue* q) { q->head = 0; q->tail = 0; }
+static void *rr_init(SimEngine *e) {
+    RunQueue *q = xmalloc(sizeof(RunQueue));
+    rq_init(q, e->count / e->ncpu);
+    return q;
+}
 
-void push(Queue* q, int v) { 
-    if(q->tail < 100) q->items[q->tail++] = v; 
+static void rr_destroy(void *st) {
+    rq_free(st);
+    free(st);
 }
 
-// FIX: Shift elements left on pop to prevent overflow
-int pop(Queue* q) {
-    if(q->tail == 0) return -1;
-    int v = q->items[0];
-    for(int i=0; i < q->tail - 1; i++) {
-        q->items[i] = q->items[i+1];
-    }
-    q->tail--;
-    return v;
+static void *rr_clone(SimEngine *e, const void *st) {
+    RunQueue *q = xmalloc(sizeof(RunQueue));
+    rq_copy(q, st);
+    return q;
 }
 
-bool empty(Queue* q) { return q->tail == 0; }
+static void rr_push(SimEngine *e, void *st, int job) { rq_push(st, job); }
 
-void run_RR(Process *p, int count) {
-    int time = 0;
-    int completed = 0;
-    Queue q; init_q(&q);
-    bool in_queue[MAX_JOBS] = {false};
+static int rr_pop(SimEngine *e, void *st) { return rq_pop(st); }
 
-    // Load initial
-    for(int i=0; i<count; i++) {
-        if(p[i].arrival_time == 0) { push(&q, i); in_queue[i] = true; }
-    }
+static int rr_quantum(SimEngine *e, void *st, int job) { return e->quantum; }
 
-    // FIX: Removed "time < TOTAL_QUANTA"
-    while (completed < count) {
-        if (!empty(&q)) {
-            // Peek to check Start Cutoff
-            int idx = q.items[0];
-            
-            // CUTOFF: If new job and time >= 100, drop it completely
-            if (p[idx].start_time == -1 && time >= TOTAL_QUANTA) {
-                pop(&q); // Remove
-                if (empty(&q) && time >= TOTAL_QUANTA) break; // Stop if done
-                continue; 
-            }
-            
-            idx = pop(&q); // Valid pop
-            
-            if (p[idx].start_time == -1) {
-                p[idx].start_time = time;
-            }
+static bool rr_contended(SimEngine *e, void *st, int job) { return !rq_empty(st); }
 
-            p[idx].remaining_time--;
-            if (time < TOTAL_QUANTA) p[idx].history[time] = true; 
-            
-            time++;
+static const SchedPolicy RR_POLICY = {
+    .name = "RR",
+    // Jobs arriving at a quantum boundary queue up ahead of the preempted job
+    .rank = { [EV_ARRIVAL] = 0, [EV_TIMER] = 1, [EV_SLICE_END] = 2 },
+    .init = rr_init,
+    .destroy = rr_destroy,
+    .arrive = rr_push,
+    .requeue = rr_push,
+    .pick = rr_pop,
+    .quantum = rr_quantum,
+    .contended = rr_contended,
+    .clone = rr_clone,
+};
 
-            // Check Arrivals
-            for(int i=0; i<count; i++) {
-                if(p[i].arrival_time == time && !in_queue[i]) {
-                    push(&q, i); in_queue[i] = true;
-                }
-            }
+const SchedPolicy *policy_RR(const SimParams *params) { return &RR_POLICY; }
 
-            if (p[idx].remaining_time > 0) push(&q, idx);
-            else { p[idx].finish_time = time; completed++; }
-        } else {
-            // Idle
-            if(time >= TOTAL_QUANTA) break; // Stop if idle past 100
-            time++;
-            for(int i=0; i<count; i++) {
-                if(p[i].arrival_time == time && !in_queue[i]) {
-                    push(&q, i); in_queue[i] = true;
-                }
-            }
-        }
-    }
-}
\ No newline at end of file
+void run_RR(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log) {
+    engine_run(spec, st, count, params, &RR_POLICY, log);
+}
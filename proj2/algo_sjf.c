@@ -1,57 +1,81 @@
-#include "scheduler.h"
-
-void run_SJF(Process *processes, int process_count) {
-    int time = 0;
-    int completed = 0;
-
-    // Initialize runtime fields (Kept original loop)
-    for (int i = 0; i < process_count; i++) {
-        processes[i].remaining_time = processes[i].run_time;
-        processes[i].start_time = -1;
-        processes[i].finish_time = 0;
-        for (int t = 0; t < TOTAL_QUANTA; t++) processes[i].history[t] = false;
-    }
-
-    // FIX: Removed "time < TOTAL_QUANTA"
-    while (completed < process_count) {
-
-        int idx = -1;
-        int shortest = 999999;
-
-        for (int i = 0; i < process_count; i++) {
-            if (processes[i].remaining_time > 0 && processes[i].arrival_time <= time) {
-                
-                // FIX: Cutoff Rule
-                if (processes[i].start_time == -1 && time >= TOTAL_QUANTA) continue;
-
-                if (processes[i].remaining_time < shortest) {
-                    shortest = processes[i].remaining_time;
-                    idx = i;
-                }
-            }
-        }
-
-        // No job ready
-        if (idx == -1) {
-            if (time >= TOTAL_QUANTA) break; // Stop if idle past 100
-            time++;
-            continue;
-        }
-
-        if (processes[idx].start_time == -1) {
-            processes[idx].start_time = time;
-        }
-
-        // Run job to completion
-        while (processes[idx].remaining_time > 0) {
-            if (time < TOTAL_QUANTA) {
-                processes[idx].history[time] = true;
-            }
-            processes[idx].remaining_time--;
-            time++;
-        }
-
-        processes[idx].finish_time = time;
-        completed++;
-    }
-}
\ No newline at end of file
+#include "engine.h"
+#include "jobheap.h"
+#include "jobtable.h"
+
+// Shortest burst wins; ties go to the earliest job in arrival order
+static bool sjf_less(const void *ctx, int a, int b) {
+    const JobState *st = ((const SimEngine *)ctx)->st;
+    if (st[a].remaining_time != st[b].remaining_time) return st[a].remaining_time < st[b].remaining_time;
+    return a < b;
+}
+
+static void *sjf_init(SimEngine *e) {
+    JobHeap *h = xmalloc(sizeof(JobHeap));
+    jheap_init(h, e, e->count, sjf_less);
+    return h;
+}
+
+static void sjf_destroy(void *st) {
+    jheap_free(st);
+    free(st);
+}
+
+static void *sjf_clone(SimEngine *e, const void *st) {
+    JobHeap *h = xmalloc(sizeof(JobHeap));
+    jheap_copy(h, st, e, e->count);
+    return h;
+}
+
+static void sjf_arrive(SimEngine *e, void *st, int job) { jheap_push(st, job); }
+
+static int sjf_pick(SimEngine *e, void *st) { return jheap_pop(st); }
+
+static const SchedPolicy SJF_POLICY = {
+    .name = "SJF",
+    .init = sjf_init,
+    .destroy = sjf_destroy,
+    .arrive = sjf_arrive,
+    .pick = sjf_pick,
+    .clone = sjf_clone,
+    // Non-preemptive: the chosen job runs to completion
+};
+
+// Scan variant: same order, the table keeps only the burst column
+static void *sjf_scan_init(SimEngine *e) {
+    JobTable *t = xmalloc(sizeof(JobTable));
+    jtable_init(t, e->count);
+    return t;
+}
+
+static void sjf_scan_destroy(void *st) {
+    jtable_free(st);
+    free(st);
+}
+
+static void *sjf_scan_clone(SimEngine *e, const void *st) {
+    JobTable *t = xmalloc(sizeof(JobTable));
+    jtable_copy(t, st, e->count);
+    return t;
+}
+
+static void sjf_scan_arrive(SimEngine *e, void *st, int job) {
+    jtable_put(st, job, e->st[job].remaining_time);
+    if (e->st[job].start_time >= 0) ((JobTable *)st)->unstarted[job] = 0; // re-arrival after engine_switch
+}
+
+static int sjf_scan_pick(SimEngine *e, void *st) { return jtable_pop(st, e->now >= e->cutoff); }
+
+static const SchedPolicy SJF_SCAN_POLICY = {
+    .name = "SJF",
+    .init = sjf_scan_init,
+    .destroy = sjf_scan_destroy,
+    .arrive = sjf_scan_arrive,
+    .pick = sjf_scan_pick,
+    .clone = sjf_scan_clone,
+};
+
+const SchedPolicy *policy_SJF(const SimParams *params) { return params->scan ? &SJF_SCAN_POLICY : &SJF_POLICY; }
+
+void run_SJF(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log) {
+    engine_run(spec, st, count, params, policy_SJF(params), log);
+}
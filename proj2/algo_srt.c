@@ -1,54 +1,106 @@
-#include "scheduler.h"
-
-static int pick_next_srt(Process *p, int n, int now) {
-    int best = -1;
-    for (int i = 0; i < n; i++) {
-        if (p[i].remaining_time <= 0) continue;
-        if (p[i].arrival_time > now) continue;
-
-        // FIX: Cutoff Rule inside selection
-        if (p[i].start_time == -1 && now >= TOTAL_QUANTA) continue;
-
-        if (best == -1) {
-            best = i;
-        } else if (p[i].remaining_time < p[best].remaining_time) {
-            best = i;
-        } else if (p[i].remaining_time == p[best].remaining_time) {
-            if (p[i].arrival_time < p[best].arrival_time)
-                best = i;
-            else if (p[i].arrival_time == p[best].arrival_time && p[i].id < p[best].id)
-                best = i;
-        }
-    }
-    return best;
-}
-
-void run_SRT(Process *processes, int process_count) {
-    int t = 0;
-    int completed = 0;
-
-    // FIX: Changed "for t < TOTAL" to "while completed < count"
-    while (completed < process_count) {
-        int idx = pick_next_srt(processes, process_count, t);
-        
-        if (idx == -1) { 
-            if (t >= TOTAL_QUANTA) break; // Stop if idle past 100
-            t++;
-            continue; 
-        }
-
-        Process *cur = &processes[idx];
-
-        if (cur->start_time < 0)
-            cur->start_time = t;
-
-        if (t < TOTAL_QUANTA) cur->history[t] = true; // Safe visual update
-        cur->remaining_time--;
-
-        if (cur->remaining_time == 0) {
-            cur->finish_time = t + 1; // Logic depends on increment time
-            completed++;
-        }
-        t++; // Increment time
-    }
-}
\ No newline at end of file
+#include "engine.h"
+#include "jobheap.h"
+#include "jobtable.h"
+
+// Order: remaining time, then arrival, then id
+static bool srt_less(const void *ctx, int a, int b) {
+    const SimEngine *e = ctx;
+    const JobState *st = e->st;
+    const JobSpec *p = e->spec;
+    if (st[a].remaining_time != st[b].remaining_time) return st[a].remaining_time < st[b].remaining_time;
+    if (p[a].arrival_time != p[b].arrival_time) return p[a].arrival_time < p[b].arrival_time;
+    return p[a].id < p[b].id;
+}
+
+static void *srt_init(SimEngine *e) {
+    JobHeap *h = xmalloc(sizeof(JobHeap));
+    jheap_init(h, e, e->count, srt_less);
+    return h;
+}
+
+static void srt_destroy(void *st) {
+    jheap_free(st);
+    free(st);
+}
+
+static void *srt_clone(SimEngine *e, const void *st) {
+    JobHeap *h = xmalloc(sizeof(JobHeap));
+    jheap_copy(h, st, e, e->count);
+    return h;
+}
+
+// The running job sits outside the heap, so its remaining time is already
+// charged when it comes back here.
+static void srt_add(SimEngine *e, void *st, int job) { jheap_push(st, job); }
+
+static int pick_next_srt(SimEngine *e, void *st) { return jheap_pop(st); }
+
+static int srt_quantum(SimEngine *e, void *st, int job) {
+    return 1;
+}
+
+// The running job only gets shorter, so nothing already waiting can overtake
+// it; only a new event (an arrival) can force a different choice.
+static bool srt_contended(SimEngine *e, void *st, int job) {
+    return false;
+}
+
+static const SchedPolicy SRT_POLICY = {
+    .name = "SRT",
+    .init = srt_init,
+    .destroy = srt_destroy,
+    .arrive = srt_add,
+    .requeue = srt_add,
+    .pick = pick_next_srt,
+    .quantum = srt_quantum,
+    .contended = srt_contended,
+    .clone = srt_clone,
+};
+
+// Scan variant: keyed by remaining time, ties by index = (arrival, id)
+static void *srt_scan_init(SimEngine *e) {
+    JobTable *t = xmalloc(sizeof(JobTable));
+    jtable_init(t, e->count);
+    return t;
+}
+
+static void srt_scan_destroy(void *st) {
+    jtable_free(st);
+    free(st);
+}
+
+static void *srt_scan_clone(SimEngine *e, const void *st) {
+    JobTable *t = xmalloc(sizeof(JobTable));
+    jtable_copy(t, st, e->count);
+    return t;
+}
+
+static void srt_scan_add(SimEngine *e, void *st, int job) {
+    jtable_put(st, job, e->st[job].remaining_time);
+    if (e->st[job].start_time >= 0) ((JobTable *)st)->unstarted[job] = 0; // never masked past the cutoff
+}
+
+static int srt_scan_pick(SimEngine *e, void *st) { return jtable_pop(st, e->now >= e->cutoff); }
+
+// A job stolen from another CPU's table has started, so it must not be
+// masked out of this one when it is requeued past the cutoff
+static void srt_scan_adopt(SimEngine *e, void *st, void *from, int job) { ((JobTable *)st)->unstarted[job] = 0; }
+
+static const SchedPolicy SRT_SCAN_POLICY = {
+    .name = "SRT",
+    .init = srt_scan_init,
+    .destroy = srt_scan_destroy,
+    .arrive = srt_scan_add,
+    .requeue = srt_scan_add,
+    .pick = srt_scan_pick,
+    .quantum = srt_quantum,
+    .contended = srt_contended,
+    .adopt = srt_scan_adopt,
+    .clone = srt_scan_clone,
+};
+
+const SchedPolicy *policy_SRT(const SimParams *params) { return params->scan ? &SRT_SCAN_POLICY : &SRT_POLICY; }
+
+void run_SRT(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log) {
+    engine_run(spec, st, count, params, policy_SRT(params), log);
+}
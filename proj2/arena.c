@@ -0,0 +1,44 @@
+#include "arena.h"
+#include "scheduler.h"
+
+#define ARENA_MIN_BLOCK 4096
+
+static void push_block(Arena *a, size_t size) {
+    ArenaBlock *b = xmalloc(sizeof(ArenaBlock) + size);
+    b->prev = a->top;
+    b->size = size;
+    b->used = 0;
+    a->top = b;
+    a->total += size;
+}
+
+void *arena_alloc(Arena *a, size_t size) {
+    size_t align = sizeof(max_align_t);
+    size = (size + align - 1) / align * align;
+    if (!a->top || a->top->size - a->top->used < size) {
+        // Grow geometrically so a run that outgrows the arena adds few blocks
+        size_t want = a->total > size ? a->total : size;
+        push_block(a, want > ARENA_MIN_BLOCK ? want : ARENA_MIN_BLOCK);
+    }
+    void *ptr = (char *)a->top->data + a->top->used;
+    a->top->used += size;
+    return ptr;
+}
+
+void arena_reset(Arena *a) {
+    if (a->top && a->top->prev) {
+        size_t total = a->total;
+        arena_free(a);
+        push_block(a, total);
+    }
+    if (a->top) a->top->used = 0;
+}
+
+void arena_free(Arena *a) {
+    while (a->top) {
+        ArenaBlock *prev = a->top->prev;
+        free(a->top);
+        a->top = prev;
+    }
+    a->total = 0;
+}
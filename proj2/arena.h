@@ -0,0 +1,27 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// --- Bump Arena ---
+// Allocations are carved off the current block and never freed one by one;
+// arena_reset drops them all at once. A reset arena keeps its memory (merged
+// into a single block big enough for everything it held), so a worker that
+// resets between runs stops calling malloc after its first run.
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *prev;
+    size_t size, used;
+    max_align_t data[];
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *top;    // block being carved, NULL until the first allocation
+    size_t total;       // bytes in all blocks
+} Arena;
+
+void *arena_alloc(Arena *a, size_t size);  // max_align_t aligned, never NULL
+void arena_reset(Arena *a);
+void arena_free(Arena *a);
+
+#endif
@@ -0,0 +1,146 @@
+// Scheduler microbenchmarks: times every AlgoFunc on synthetic workloads of
+// 10 to 10^6 jobs under several arrival patterns and prints JSON.
+//
+//   make bench && ./bench [-max N] [-min-time SEC] [-scan] [-cpus N]
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "scheduler.h"
+#include "rng.h"
+
+#define BENCH_SEED 383
+
+static const char *names[] = {"FCFS", "SJF", "SRT", "RR", "HPF-NP", "HPF-Pre", "CFS", "Lottery", "Stride"};
+static AlgoFunc funcs[] = {run_FCFS, run_SJF, run_SRT, run_RR, run_HPF_NonPreemptive, run_HPF_Preemptive, run_CFS, run_Lottery, run_Stride};
+#define NUM_ALGOS (int)(sizeof(funcs) / sizeof(funcs[0]))
+
+// --- Arrival Patterns ---
+
+typedef enum { PAT_STEADY, PAT_BURSTY, PAT_SPARSE, PAT_BATCH, NUM_PATTERNS } Pattern;
+
+static const char *pattern_names[] = {
+    "steady",   // uniform gaps, CPU slightly overloaded
+    "bursty",   // groups of 64 jobs at one instant, then a lull
+    "sparse",   // long gaps, the CPU is idle much of the time
+    "batch",    // every job at t=0: the largest possible ready set
+};
+
+static void build_workload(JobSpec *w, int count, Pattern pat) {
+    Rng rng;
+    rng_seed(&rng, BENCH_SEED, (uint64_t)pat * 1000003 + count);
+
+    int arrival = 0;
+    for (int i = 0; i < count; i++) {
+        switch (pat) {
+        case PAT_STEADY: arrival += rng_range(&rng, 10); break;
+        case PAT_BURSTY: if (i % 64 == 0 && i > 0) arrival += 64 * 6; break;
+        case PAT_SPARSE: arrival += rng_range(&rng, 41); break;
+        default: break;
+        }
+        w[i].id = i + 1;
+        w[i].name = (i < 26) ? ('A' + i) : '?';
+        w[i].arrival_time = arrival;
+        w[i].run_time = rng_range(&rng, 10) + 1;
+        w[i].priority = rng_range(&rng, 4) + 1;
+    }
+}
+
+// --- Measurement Helpers ---
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Resets the kernel's peak-RSS mark so each case reports its own peak (Linux)
+static void reset_peak_rss(void) {
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (!f) return;
+    fputs("5", f);
+    fclose(f);
+}
+
+static long peak_rss_kb(void) {
+    FILE *f = fopen("/proc/self/status", "r");
+    if (f) {
+        char line[128];
+        long kb = -1;
+        while (fgets(line, sizeof(line), f)) {
+            if (sscanf(line, "VmHWM: %ld kB", &kb) == 1) break;
+        }
+        fclose(f);
+        if (kb >= 0) return kb;
+    }
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+int main(int argc, char *argv[]) {
+    int max_jobs = 1000000;
+    double min_time = 0.2; // seconds of repetitions per case
+    bool scan = false;     // SoA min-scan selection instead of heaps
+    int cpus = 1;          // simulated CPUs
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-max") == 0 && i + 1 < argc) max_jobs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-min-time") == 0 && i + 1 < argc) min_time = atof(argv[++i]);
+        else if (strcmp(argv[i], "-scan") == 0) scan = true;
+        else if (strcmp(argv[i], "-cpus") == 0 && i + 1 < argc) cpus = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [-max N] [-min-time SEC] [-scan] [-cpus N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("{\n  \"benchmark\": \"proj2-scheduler\",\n  \"selection\": \"%s\",\n  \"cpus\": %d,\n  \"results\": [", scan ? "scan" : "heap", cpus);
+    bool first = true;
+
+    for (int pat = 0; pat < NUM_PATTERNS; pat++) {
+        for (int count = 10; count <= max_jobs; count *= 10) {
+            JobSpec *spec = xmalloc(sizeof(JobSpec) * count);
+            JobState *st = xmalloc(sizeof(JobState) * count);
+            build_workload(spec, count, pat);
+
+            for (int a = 0; a < NUM_ALGOS; a++) {
+                EngineStats es = {0};
+                SimParams params = { .cutoff = INT_MAX, .stats = &es, .scan = scan, .cpus = cpus, .seed = BENCH_SEED };
+                SegmentLog log = {0};
+
+                reset_peak_rss();
+                double elapsed = 0;
+                int reps = 0;
+                do {
+                    jobstate_init(st, spec, count);
+                    log.count = 0;
+                    double t0 = now_sec();
+                    funcs[a](spec, st, count, &params, &log);
+                    elapsed += now_sec() - t0;
+                    reps++;
+                } while (elapsed < min_time);
+                long rss = peak_rss_kb();
+
+                double ns_run = elapsed / reps * 1e9;
+                printf("%s\n    {\"algorithm\": \"%s\", \"pattern\": \"%s\", \"jobs\": %d, \"reps\": %d, "
+                       "\"ns_per_run\": %.0f, \"ns_per_job\": %.2f, \"ns_per_decision\": %.2f, "
+                       "\"decisions\": %ld, \"events\": %ld, \"segments\": %d, \"peak_rss_kb\": %ld}",
+                       first ? "" : ",", names[a], pattern_names[pat], count, reps,
+                       ns_run, ns_run / count, es.decisions ? ns_run / es.decisions : 0.0,
+                       es.decisions, es.events, log.count, rss);
+                first = false;
+                fflush(stdout);
+                seglog_free(&log);
+            }
+            free(spec);
+            free(st);
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
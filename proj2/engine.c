@@ -0,0 +1,419 @@
+#include <limits.h>
+#include <string.h>
+#include "engine.h"
+
+void *xmalloc(size_t size) {
+    void *ptr = malloc(size);
+    if (!ptr && size) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+void *xcalloc(size_t n, size_t size) {
+    void *ptr = calloc(n, size);
+    if (!ptr && n && size) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+void *xmemdup(const void *src, size_t size) {
+    void *ptr = xmalloc(size);
+    if (size) memcpy(ptr, src, size);
+    return ptr;
+}
+
+// --- Segment Log ---
+
+// Appends [start, end) for 'job' on 'cpu', extending the last entry when the
+// same job simply kept the CPU (e.g. a quantum expired with nobody else ready).
+void seglog_append(SegmentLog *log, int job, int cpu, int start, int end) {
+    if (start >= end) return;
+    if (log->count > 0) {
+        Segment *last = &log->seg[log->count - 1];
+        if (last->job == job && last->cpu == cpu && last->end == start) {
+            last->end = end;
+            return;
+        }
+    }
+    if (log->count == log->cap) {
+        log->cap = log->cap ? log->cap * 2 : 32;
+        log->seg = realloc(log->seg, log->cap * sizeof(Segment));
+        if (!log->seg) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    log->seg[log->count++] = (Segment){ job, cpu, start, end };
+}
+
+void seglog_free(SegmentLog *log) {
+    free(log->seg);
+    log->seg = NULL;
+    log->count = log->cap = 0;
+}
+
+// --- Event Heap ---
+
+static bool event_before(const Event *a, const Event *b) {
+    if (a->time != b->time) return a->time < b->time;
+    if (a->rank != b->rank) return a->rank < b->rank;
+    return a->seq < b->seq;
+}
+
+static void eq_push(EventQueue *q, Event ev) {
+    if (q->size == q->cap) {
+        q->cap = q->cap ? q->cap * 2 : 16;
+        q->heap = realloc(q->heap, q->cap * sizeof(Event));
+        if (!q->heap) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    ev.seq = q->next_seq++;
+
+    // Sift up
+    int i = q->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!event_before(&ev, &q->heap[parent])) break;
+        q->heap[i] = q->heap[parent];
+        i = parent;
+    }
+    q->heap[i] = ev;
+}
+
+static Event eq_pop(EventQueue *q) {
+    Event top = q->heap[0];
+    Event last = q->heap[--q->size];
+
+    // Sift down
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= q->size) break;
+        if (child + 1 < q->size && event_before(&q->heap[child + 1], &q->heap[child])) child++;
+        if (!event_before(&q->heap[child], &last)) break;
+        q->heap[i] = q->heap[child];
+        i = child;
+    }
+    if (q->size > 0) q->heap[i] = last;
+    return top;
+}
+
+static void push_event(SimEngine *e, int time, int type, int job) {
+    Event ev = { .time = time, .rank = e->policy->rank[type], .type = type, .job = job };
+    eq_push(&e->events, ev);
+}
+
+void engine_schedule_timer(SimEngine *e, int time, int job) {
+    push_event(e, time, EV_TIMER, job);
+}
+
+// Only the next arrival is kept in the heap; the next one is armed when it fires.
+// Jobs arriving at or after the cutoff could never start, so they are not delivered.
+static void arm_next_arrival(SimEngine *e) {
+    if (e->next_arrival >= e->count) return;
+    int job = e->next_arrival;
+    int arrival = e->source ? e->source->arrival(e->source, job) : e->spec[job].arrival_time;
+    if (arrival < e->now) {
+        fprintf(stderr, "Job %d arrives at %d, before job %d: input not sorted by arrival\n", job + 1, arrival, job);
+        exit(1);
+    }
+    if (arrival >= e->cutoff) return;
+    push_event(e, arrival, EV_ARRIVAL, job);
+}
+
+// Streams a job's spec in from the source and resets its run state
+static void load_job(SimEngine *e, int job) {
+    memset(&e->stream[job], 0, sizeof(JobSpec));
+    e->source->load(e->source, job, &e->stream[job]);
+    jobstate_init(&e->st[job], &e->stream[job], 1);
+}
+
+static inline int home_of(const SimEngine *e, int job) { return e->home ? e->home[job] : 0; }
+
+// CPU with the most jobs waiting (lowest index on ties), -1 if all are empty
+static int steal_victim(const SimEngine *e, int thief) {
+    int victim = -1;
+    for (int c = 0; c < e->ncpu; c++) {
+        if (c == thief || e->cpu[c].queued == 0) continue;
+        if (victim < 0 || e->cpu[c].queued > e->cpu[victim].queued) victim = c;
+    }
+    return victim;
+}
+
+// Next job for CPU 'c': from its own ready set, else stolen. Sets *from to
+// the CPU whose set it came from; -1 when nothing is ready anywhere.
+static int pick_for(SimEngine *e, int c, int *from) {
+    const SchedPolicy *pol = e->policy;
+    int src = c;
+    for (;;) {
+        int job = pol->pick(e, e->cpu[src].state);
+        if (job < 0) {
+            // Whatever is left can never be picked (masked past the cutoff)
+            e->waiting -= e->cpu[src].queued;
+            e->cpu[src].queued = 0;
+            src = steal_victim(e, c);
+            if (src < 0) return -1;
+            continue;
+        }
+        e->cpu[src].queued--;
+        e->waiting--;
+        // CUTOFF: a job that has not started before the cutoff is dropped
+        if (e->st[job].start_time == -1 && e->now >= e->cutoff) continue;
+        *from = src;
+        return job;
+    }
+}
+
+static void dispatch(SimEngine *e, int c) {
+    const SchedPolicy *pol = e->policy;
+    Cpu *cpu = &e->cpu[c];
+    int from;
+    int job = pick_for(e, c, &from);
+    if (job < 0) return;
+
+    if (from != c) {
+        if (pol->adopt) pol->adopt(e, cpu->state, e->cpu[from].state, job);
+        e->home[job] = c;
+        cpu->stats.migrations++;
+    }
+
+    JobState *cur = &e->st[job];
+    if (cur->start_time == -1) cur->start_time = e->now;
+    e->decisions++;
+
+    cpu->running = job;
+    cpu->dispatch_time = e->now;
+    e->idle--;
+
+    int end = e->now + cur->remaining_time;
+    int q = pol->quantum ? pol->quantum(e, cpu->state, job) : 0;
+    if (q > 0) {
+        long slice = q;
+        if (pol->contended && !pol->contended(e, cpu->state, job)) {
+            // Nobody to switch to: run on to the first quantum boundary at
+            // or after the next event.
+            if (e->events.size == 0) slice = LONG_MAX;
+            else {
+                long gap = (long)e->events.heap[0].time - e->now;
+                if (gap > q) slice = ((gap + q - 1) / q) * q;
+            }
+        }
+        if (slice < cur->remaining_time) end = e->now + (int)slice;
+    }
+    push_event(e, end, EV_SLICE_END, job);
+}
+
+// Least loaded CPU (waiting + running), lowest index on ties
+static int place(const SimEngine *e) {
+    int best = 0, best_load = INT_MAX;
+    for (int c = 0; c < e->ncpu && best_load > 0; c++) {
+        int load = e->cpu[c].queued + (e->cpu[c].running >= 0);
+        if (load < best_load) {
+            best = c;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+static void handle_event(SimEngine *e, Event ev) {
+    const SchedPolicy *pol = e->policy;
+
+    switch (ev.type) {
+    case EV_ARRIVAL: {
+        if (e->source) load_job(e, ev.job);
+        e->next_arrival++;
+        int c = place(e);
+        if (e->home) e->home[ev.job] = c;
+        e->cpu[c].queued++;
+        e->waiting++;
+        pol->arrive(e, e->cpu[c].state, ev.job);
+        arm_next_arrival(e);
+        break;
+    }
+
+    case EV_SLICE_END: {
+        JobState *cur = &e->st[ev.job];
+        Cpu *cpu = &e->cpu[home_of(e, ev.job)];
+        if (e->log) seglog_append(e->log, ev.job, home_of(e, ev.job), cpu->dispatch_time, e->now);
+        cur->remaining_time -= e->now - cpu->dispatch_time;
+        cpu->stats.busy += e->now - cpu->dispatch_time;
+        cpu->running = -1;
+        e->idle++;
+        if (cur->remaining_time == 0) cur->finish_time = e->now;
+        else {
+            cpu->queued++;
+            e->waiting++;
+            pol->requeue(e, cpu->state, ev.job);
+        }
+        break;
+    }
+
+    case EV_TIMER:
+        if (pol->timer) pol->timer(e, e->cpu[home_of(e, ev.job)].state, ev.job);
+        break;
+    }
+}
+
+// Dispatches idle CPUs once every event at this instant has been applied
+static void decide(SimEngine *e) {
+    if (e->idle > 0 && e->waiting > 0 && (e->events.size == 0 || e->events.heap[0].time > e->now)) {
+        for (int c = 0; c < e->ncpu && e->waiting > 0; c++) {
+            if (e->cpu[c].running == -1) dispatch(e, c);
+        }
+    }
+}
+
+void jobstate_init(JobState *st, const JobSpec *spec, int count) {
+    for (int i = 0; i < count; i++) {
+        st[i].remaining_time = spec[i].run_time;
+        st[i].start_time = -1;
+        st[i].finish_time = 0;
+        st[i].priority = spec[i].priority;
+    }
+}
+
+SimEngine *engine_create(const JobSpec *spec, JobState *st, int count, const SimParams *params, const SchedPolicy *policy, SegmentLog *log) {
+    SimEngine *e = xcalloc(1, sizeof(SimEngine));
+    e->spec = spec;
+    e->st = st;
+    e->count = count;
+    e->log = log;
+    e->cutoff = params->cutoff;
+    e->source = params->source;
+    if (e->source) e->spec = e->stream = params->stream_specs;
+    e->min_granularity = params->min_granularity;
+    e->quantum = params->quantum > 0 ? params->quantum : DEFAULT_QUANTUM;
+    e->aging_limit = params->aging_limit > 0 ? params->aging_limit : DEFAULT_AGING_LIMIT;
+    e->policy = policy;
+    rng_seed(&e->rng, params->seed, 1); // stream 0 generates workloads
+    e->ncpu = params->cpus > 1 ? params->cpus : 1;
+    e->idle = e->ncpu;
+    e->cpu = xcalloc(e->ncpu, sizeof(Cpu));
+    if (e->ncpu > 1) e->home = xcalloc(count > 0 ? count : 1, sizeof(int));
+    for (int c = 0; c < e->ncpu; c++) {
+        e->cpu[c].running = -1;
+        e->cpu[c].state = policy->init(e);
+    }
+    arm_next_arrival(e);
+    return e;
+}
+
+bool engine_advance(SimEngine *e, int until) {
+    while (e->events.size > 0 && e->events.heap[0].time < until) {
+        Event ev = eq_pop(&e->events);
+        e->now = ev.time;
+        e->events_handled++;
+        handle_event(e, ev);
+        decide(e);
+    }
+    if (e->events.size == 0) return false;
+    e->now = until;
+    return true;
+}
+
+SimEngine *engine_fork(const SimEngine *e, JobState *st, SegmentLog *log) {
+    SimEngine *f = xmemdup(e, sizeof(SimEngine));
+    f->st = st;
+    memcpy(st, e->st, sizeof(JobState) * e->count);
+    f->log = log;
+    if (log && e->log) {
+        log->count = log->cap = e->log->count;
+        log->seg = xmemdup(e->log->seg, sizeof(Segment) * e->log->count);
+    }
+    f->cpu = xmemdup(e->cpu, sizeof(Cpu) * e->ncpu);
+    for (int c = 0; c < e->ncpu; c++) f->cpu[c].state = e->policy->clone(f, e->cpu[c].state);
+    if (e->home) f->home = xmemdup(e->home, sizeof(int) * (e->count > 0 ? e->count : 1));
+    f->events.heap = xmemdup(e->events.heap, sizeof(Event) * e->events.cap);
+    return f;
+}
+
+static int cmp_int(const void *x, const void *y) {
+    int a = *(const int *)x, b = *(const int *)y;
+    return (a > b) - (a < b);
+}
+
+void engine_switch(SimEngine *e, const SchedPolicy *policy) {
+    const SchedPolicy *old = e->policy;
+    if (policy == old) return;
+    int *jobs = xmalloc(sizeof(int) * (e->waiting + e->ncpu + 1));
+    int n = 0;
+
+    for (int c = 0; c < e->ncpu; c++) {
+        Cpu *cpu = &e->cpu[c];
+
+        // Preempt the running job, charging it up to now
+        int job = cpu->running;
+        if (job >= 0) {
+            JobState *cur = &e->st[job];
+            if (e->log) seglog_append(e->log, job, c, cpu->dispatch_time, e->now);
+            cur->remaining_time -= e->now - cpu->dispatch_time;
+            cpu->stats.busy += e->now - cpu->dispatch_time;
+            cpu->running = -1;
+            e->idle++;
+            if (cur->remaining_time == 0) cur->finish_time = e->now;
+            else jobs[n++] = job;
+        }
+
+        // Drain the ready set; jobs it can no longer hand out are dropped
+        while ((job = old->pick(e, cpu->state)) >= 0) {
+            if (e->st[job].start_time == -1 && e->now >= e->cutoff) continue; // CUTOFF
+            jobs[n++] = job;
+        }
+        if (old->destroy) old->destroy(cpu->state);
+        cpu->queued = 0;
+    }
+    e->waiting = 0;
+
+    // Slice ends and timers belong to the old policy; only the next arrival survives
+    Event arrival = {0};
+    bool armed = false;
+    for (int i = 0; i < e->events.size; i++) {
+        if (e->events.heap[i].type == EV_ARRIVAL) {
+            arrival = e->events.heap[i];
+            armed = true;
+        }
+    }
+    e->events.size = 0;
+    e->policy = policy;
+    if (armed) push_event(e, arrival.time, EV_ARRIVAL, arrival.job);
+
+    // Re-arrive in index (= arrival) order, as the scan tables require
+    qsort(jobs, n, sizeof(int), cmp_int);
+    for (int c = 0; c < e->ncpu; c++) e->cpu[c].state = policy->init(e);
+    for (int i = 0; i < n; i++) {
+        Cpu *cpu = &e->cpu[home_of(e, jobs[i])];
+        cpu->queued++;
+        e->waiting++;
+        policy->arrive(e, cpu->state, jobs[i]);
+    }
+    free(jobs);
+    decide(e);
+}
+
+void engine_destroy(SimEngine *e, const SimParams *params) {
+    if (params && params->stats) {
+        params->stats->events = e->events_handled;
+        params->stats->decisions = e->decisions;
+    }
+    for (int c = 0; c < e->ncpu; c++) {
+        if (params && params->cpu_stats) params->cpu_stats[c] = e->cpu[c].stats;
+        if (e->policy->destroy) e->policy->destroy(e->cpu[c].state);
+    }
+    free(e->cpu);
+    free(e->home);
+    free(e->events.heap);
+    free(e);
+}
+
+void engine_run(const JobSpec *spec, JobState *st, int count, const SimParams *params, const SchedPolicy *policy, SegmentLog *log) {
+    SimEngine *e = engine_create(spec, st, count, params, policy, log);
+    engine_advance(e, INT_MAX);
+    engine_destroy(e, params);
+}
@@ -0,0 +1,143 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "scheduler.h"
+#include "rng.h"
+
+// --- Discrete-Event Core ---
+// The engine keeps a min-heap of pending events and jumps straight from one
+// decision point to the next, so idle gaps and long uninterrupted bursts cost
+// one event instead of one iteration per quantum.
+
+typedef enum {
+    EV_ARRIVAL,     // next job in arrival order becomes ready
+    EV_SLICE_END,   // running job completes or its quantum expires
+    EV_TIMER,       // policy-owned timer (e.g. HPF aging)
+    EV_TYPES
+} EventType;
+
+typedef struct {
+    int time;
+    int rank;       // order among events at the same time (set by the policy)
+    unsigned seq;   // FIFO among equal (time, rank)
+    int type;
+    int job;
+} Event;
+
+typedef struct {
+    Event *heap;
+    int size, cap;
+    unsigned next_seq;
+} EventQueue;
+
+typedef struct SimEngine SimEngine;
+
+// A scheduling policy plugged into the engine.
+// 'pick' removes the chosen job from the ready set (-1 if nothing is ready),
+// 'requeue' puts a job back after its quantum expired.
+// 'quantum' returns the slice length, or 0 to run the job to completion.
+// While 'contended' is false the slice is stretched to the next event, since
+// re-picking at every quantum boundary would return the same job anyway.
+// With several CPUs every CPU gets its own state from 'init'; 'adopt'
+// (optional) carries a stolen job's per-job bookkeeping from the victim's
+// state 'from' over to the thief's state 'st'.
+// 'clone' deep-copies a state for engine_fork; 'e' is the new engine.
+typedef struct {
+    const char *name;
+    int rank[EV_TYPES];
+    void *(*init)(SimEngine *e);
+    void (*destroy)(void *st);
+    void (*arrive)(SimEngine *e, void *st, int job);
+    void (*requeue)(SimEngine *e, void *st, int job);
+    int  (*pick)(SimEngine *e, void *st);
+    int  (*quantum)(SimEngine *e, void *st, int job);
+    bool (*contended)(SimEngine *e, void *st, int job);
+    void (*timer)(SimEngine *e, void *st, int job);
+    void (*adopt)(SimEngine *e, void *st, void *from, int job);
+    void *(*clone)(SimEngine *e, const void *st);
+} SchedPolicy;
+
+// One simulated CPU: its own ready set plus what it is running
+typedef struct {
+    void *state;        // policy state holding this CPU's ready jobs
+    int queued;         // jobs waiting in 'state'
+    int running;        // job on the CPU, -1 when idle
+    int dispatch_time;
+    CpuStats stats;
+} Cpu;
+
+struct SimEngine {
+    const JobSpec *spec; // shared, read-only (loaded from 'source' into 'stream')
+    JobState *st;       // this run's job state
+    int count;
+    int now;
+    int cutoff;         // jobs that have not started by now are dropped
+    int min_granularity; // policy knob from SimParams (0 = policy default)
+    int quantum;        // RR time slice
+    int aging_limit;    // HPF aging threshold
+    int next_arrival;   // index of the next job to arrive (spec is arrival-sorted)
+    Cpu *cpu;
+    int ncpu;
+    int idle;           // CPUs with nothing running
+    int waiting;        // jobs in all ready sets
+    int *home;          // CPU whose ready set holds or runs each job (NULL with one CPU)
+    EventQueue events;
+    const SchedPolicy *policy;
+    SegmentLog *log;    // optional execution history
+    const JobSource *source; // optional: jobs are loaded into stream[] on arrival
+    JobSpec *stream;
+    Rng rng;            // for randomized policies, seeded from SimParams
+    long events_handled;
+    long decisions;
+};
+
+// Runs 'policy' over spec[0..count) (sorted by arrival; NULL when
+// params->source streams the jobs) with run state st[] on params->cpus CPUs
+// until no events remain, appending every CPU stretch to 'log' when it is
+// non-NULL.
+// Each arrival joins the ready set of the least loaded CPU, a preempted job
+// goes back to its own CPU, and a CPU whose ready set is empty steals the
+// best job from the CPU with the most waiting.
+void engine_run(const JobSpec *spec, JobState *st, int count, const SimParams *params, const SchedPolicy *policy, SegmentLog *log);
+
+// Arms a policy timer; 'timer' is called with 'job' when it fires.
+void engine_schedule_timer(SimEngine *e, int time, int job);
+
+// --- Stepping, Snapshots and What-If Branches ---
+// engine_run is create, advance to INT_MAX, destroy. An engine stopped by
+// engine_advance is a snapshot: engine_fork copies it (job progress, ready
+// sets, pending events, RNG) so any number of branches can continue from
+// one shared prefix instead of replaying it. Job specs and the JobSource
+// are shared, not copied (forks of a streamed run must stay on one thread).
+
+SimEngine *engine_create(const JobSpec *spec, JobState *st, int count, const SimParams *params, const SchedPolicy *policy, SegmentLog *log);
+
+// Handles every event before 'until' and leaves the clock at 'until';
+// false once nothing is left to simulate
+bool engine_advance(SimEngine *e, int until);
+
+// Independent copy of 'e' working on 'st' ([count], filled from e->st) and
+// appending to 'log' (optional; gets a copy of e's history if e has one)
+SimEngine *engine_fork(const SimEngine *e, JobState *st, SegmentLog *log);
+
+// From now on schedule with 'policy': running jobs are preempted and every
+// unfinished job re-arrives at the current time, in arrival order, on the
+// CPU it was on. Pending timers of the old policy are dropped.
+void engine_switch(SimEngine *e, const SchedPolicy *policy);
+
+// Fills params->stats and params->cpu_stats (params may be NULL) and frees 'e'
+void engine_destroy(SimEngine *e, const SimParams *params);
+
+// --- Policies ---
+// The policy each run_* function would use under 'params'
+const SchedPolicy *policy_FCFS(const SimParams *params);
+const SchedPolicy *policy_SJF(const SimParams *params);
+const SchedPolicy *policy_SRT(const SimParams *params);
+const SchedPolicy *policy_RR(const SimParams *params);
+const SchedPolicy *policy_HPF_NonPreemptive(const SimParams *params);
+const SchedPolicy *policy_HPF_Preemptive(const SimParams *params);
+const SchedPolicy *policy_CFS(const SimParams *params);
+const SchedPolicy *policy_Lottery(const SimParams *params);
+const SchedPolicy *policy_Stride(const SimParams *params);
+
+#endif
@@ -0,0 +1,109 @@
+#include <errno.h>
+#include <string.h>
+#include "gantt.h"
+
+#define GANTT_BUFFER (1 << 20)
+
+bool gantt_open(GanttWriter *g, const char *path, const char *const *algos, int num_algos) {
+    memset(g, 0, sizeof(GanttWriter));
+    size_t len = strlen(path);
+    g->csv = len >= 4 && strcmp(path + len - 4, ".csv") == 0;
+    g->path = path;
+    g->names = algos;
+    g->f = fopen(path, g->csv ? "w" : "wb");
+    if (!g->f) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    setvbuf(g->f, NULL, _IOFBF, GANTT_BUFFER);
+
+    if (g->csv) {
+        fputs("run,algo,job,cpu,start,end\n", g->f);
+        return true;
+    }
+
+    GanttHeader h = { .num_algos = num_algos, .name_len = GANTT_NAME_LEN };
+    memcpy(h.magic, GANTT_MAGIC, 8);
+    fwrite(&h, sizeof(h), 1, g->f);
+    for (int a = 0; a < num_algos; a++) {
+        char name[GANTT_NAME_LEN] = {0};
+        strncpy(name, algos[a], GANTT_NAME_LEN - 1);
+        fwrite(name, GANTT_NAME_LEN, 1, g->f);
+    }
+    return true;
+}
+
+// Formats 'v' (>= 0) at 'out' followed by 'sep'; returns the end
+static char *put_int(char *out, int v, char sep) {
+    char tmp[12];
+    int n = 0;
+    do {
+        tmp[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v > 0);
+    while (n > 0) *out++ = tmp[--n];
+    *out++ = sep;
+    return out;
+}
+
+static void add_csv(GanttWriter *g, int run, const char *algo, const SegmentLog *log) {
+    char line[128];
+    size_t algo_len = strlen(algo);
+    for (int s = 0; s < log->count; s++) {
+        const Segment *seg = &log->seg[s];
+        char *out = put_int(line, run, ',');
+        memcpy(out, algo, algo_len);
+        out += algo_len;
+        *out++ = ',';
+        out = put_int(out, seg->job, ',');
+        out = put_int(out, seg->cpu, ',');
+        out = put_int(out, seg->start, ',');
+        out = put_int(out, seg->end, '\n');
+        fwrite(line, 1, out - line, g->f);
+    }
+}
+
+void gantt_add(GanttWriter *g, int run, int algo, const SegmentLog *log) {
+    if (g->csv) {
+        add_csv(g, run, g->names[algo], log);
+        return;
+    }
+    if (g->rows + log->count > g->cap) {
+        while (g->rows + log->count > g->cap) g->cap = g->cap ? g->cap * 2 : 4096;
+        for (int c = 0; c < GANTT_COLUMNS; c++) {
+            g->col[c] = realloc(g->col[c], sizeof(int32_t) * g->cap);
+            if (!g->col[c]) {
+                fprintf(stderr, "Out of memory\n");
+                exit(1);
+            }
+        }
+    }
+    for (int s = 0; s < log->count; s++) {
+        const Segment *seg = &log->seg[s];
+        uint32_t r = g->rows++;
+        g->col[0][r] = run;
+        g->col[1][r] = algo;
+        g->col[2][r] = seg->job;
+        g->col[3][r] = seg->cpu;
+        g->col[4][r] = seg->start;
+        g->col[5][r] = seg->end;
+    }
+}
+
+void gantt_flush(GanttWriter *g) {
+    if (g->csv || g->rows == 0) return;
+    GanttBlock b = { .rows = g->rows, .columns = GANTT_COLUMNS };
+    fwrite(&b, sizeof(b), 1, g->f);
+    for (int c = 0; c < GANTT_COLUMNS; c++) fwrite(g->col[c], sizeof(int32_t), g->rows, g->f);
+    g->rows = 0;
+}
+
+bool gantt_close(GanttWriter *g) {
+    gantt_flush(g);
+    bool ok = !ferror(g->f);
+    if (fclose(g->f) != 0) ok = false;
+    if (!ok) fprintf(stderr, "%s: write error\n", g->path);
+    for (int c = 0; c < GANTT_COLUMNS; c++) free(g->col[c]);
+    memset(g, 0, sizeof(GanttWriter));
+    return ok;
+}
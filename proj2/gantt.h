@@ -0,0 +1,54 @@
+#ifndef GANTT_H
+#define GANTT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "scheduler.h"
+
+// --- Gantt Segment Export ---
+// Every CPU stretch of every run goes into one file, written by a single
+// thread in run order.
+//   *.csv:  run,algo,job,cpu,start,end rows
+//   other:  binary, a GanttHeader plus the algorithm names, then one
+//           columnar block per batch of runs: a GanttBlock followed by six
+//           int32 columns of 'rows' entries each (run, algo, job, cpu,
+//           start, end), host byte order
+// 'job' is the job id; 'algo' indexes the header's name table.
+
+#define GANTT_MAGIC "SCHGNT01"
+#define GANTT_NAME_LEN 16
+#define GANTT_COLUMNS 6
+
+typedef struct {
+    char magic[8];
+    uint32_t num_algos;     // followed by num_algos names of GANTT_NAME_LEN bytes
+    uint32_t name_len;
+} GanttHeader;
+
+typedef struct {
+    uint32_t rows;
+    uint32_t columns;       // GANTT_COLUMNS
+} GanttBlock;
+
+typedef struct {
+    FILE *f;
+    const char *path;
+    const char *const *names;   // algorithm names, indexed by 'algo'
+    bool csv;
+    int32_t *col[GANTT_COLUMNS];    // binary: rows buffered for the current block
+    uint32_t rows, cap;
+} GanttWriter;
+
+// Opens 'path' and writes the header; prints the reason on failure
+bool gantt_open(GanttWriter *g, const char *path, const char *const *algos, int num_algos);
+
+// Adds one run's log; its 'job' fields must already hold job ids
+void gantt_add(GanttWriter *g, int run, int algo, const SegmentLog *log);
+
+// Ends a batch of runs (binary: writes the buffered block)
+void gantt_flush(GanttWriter *g);
+
+// Flushes and closes; false if anything failed to write
+bool gantt_close(GanttWriter *g);
+
+#endif
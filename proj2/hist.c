@@ -0,0 +1,47 @@
+#include <math.h>
+#include "hist.h"
+
+static int bucket_of(unsigned v) {
+    if (v < (1u << HIST_SUB_BITS)) return (int)v;
+    int msb = 31 - __builtin_clz(v);
+    int shift = msb - HIST_SUB_BITS + 1;
+    return shift * HIST_HALF + (int)(v >> shift);
+}
+
+// Largest value that lands in bucket b
+static int bucket_top(int b) {
+    if (b < (1 << HIST_SUB_BITS)) return b;
+    int shift = b / HIST_HALF - 1;
+    long sub = b - shift * HIST_HALF;
+    long top = ((sub + 1) << shift) - 1;
+    return top > INT32_MAX ? INT32_MAX : (int)top;
+}
+
+void hist_record(Hist *h, int value) {
+    if (value < 0) value = 0;
+    h->counts[bucket_of((unsigned)value)]++;
+    h->total++;
+    if (value > h->max) h->max = value;
+}
+
+void hist_merge(Hist *dst, const Hist *src) {
+    if (src->total == 0) return;
+    for (int b = 0; b < HIST_BUCKETS; b++) dst->counts[b] += src->counts[b];
+    dst->total += src->total;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+int hist_percentile(const Hist *h, double q) {
+    if (h->total == 0) return 0;
+    uint64_t rank = (uint64_t)ceil(q / 100.0 * (double)h->total);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen >= rank) {
+            int top = bucket_top(b);
+            return top < h->max ? top : h->max;
+        }
+    }
+    return h->max;
+}
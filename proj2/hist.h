@@ -0,0 +1,29 @@
+#ifndef HIST_H
+#define HIST_H
+
+#include <stdint.h>
+
+// --- Log-Linear Latency Histogram ---
+// HDR-style: values below 2^HIST_SUB_BITS get a bucket each, larger values
+// share HIST_HALF buckets per power of two, so any int is recorded in O(1)
+// with under 2^-(HIST_SUB_BITS-1) relative error and a fixed footprint.
+// Counts only add, so histograms merge exactly in any order.
+
+#define HIST_SUB_BITS 7
+#define HIST_HALF (1 << (HIST_SUB_BITS - 1))
+#define HIST_BUCKETS ((31 - HIST_SUB_BITS + 2) * HIST_HALF)
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    int max;            // exact
+} Hist;
+
+void hist_record(Hist *h, int value);   // negative values count as 0
+void hist_merge(Hist *dst, const Hist *src);
+
+// Smallest recorded value v such that at least q percent of samples are <= v,
+// reported as the top of its bucket (never above max); 0 when empty
+int hist_percentile(const Hist *h, double q);
+
+#endif
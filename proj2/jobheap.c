@@ -0,0 +1,79 @@
+#include "jobheap.h"
+
+void jheap_init(JobHeap *h, const void *ctx, int count, JobLess less) {
+    if (count < 1) count = 1;
+    h->heap = xmalloc(sizeof(int) * count);
+    h->pos = xmalloc(sizeof(int) * count);
+    for (int i = 0; i < count; i++) h->pos[i] = -1;
+    h->size = 0;
+    h->ctx = ctx;
+    h->less = less;
+}
+
+void jheap_free(JobHeap *h) {
+    free(h->heap);
+    free(h->pos);
+    h->heap = h->pos = NULL;
+    h->size = 0;
+}
+
+void jheap_copy(JobHeap *dst, const JobHeap *src, const void *ctx, int count) {
+    if (count < 1) count = 1;
+    *dst = *src;
+    dst->heap = xmemdup(src->heap, sizeof(int) * count);
+    dst->pos = xmemdup(src->pos, sizeof(int) * count);
+    dst->ctx = ctx;
+}
+
+static void place(JobHeap *h, int slot, int job) {
+    h->heap[slot] = job;
+    h->pos[job] = slot;
+}
+
+static void sift_up(JobHeap *h, int slot) {
+    int job = h->heap[slot];
+    while (slot > 0) {
+        int parent = (slot - 1) / 2;
+        if (!h->less(h->ctx, job, h->heap[parent])) break;
+        place(h, slot, h->heap[parent]);
+        slot = parent;
+    }
+    place(h, slot, job);
+}
+
+static void sift_down(JobHeap *h, int slot) {
+    int job = h->heap[slot];
+    for (;;) {
+        int child = 2 * slot + 1;
+        if (child >= h->size) break;
+        if (child + 1 < h->size && h->less(h->ctx, h->heap[child + 1], h->heap[child])) child++;
+        if (!h->less(h->ctx, h->heap[child], job)) break;
+        place(h, slot, h->heap[child]);
+        slot = child;
+    }
+    place(h, slot, job);
+}
+
+void jheap_push(JobHeap *h, int job) {
+    h->heap[h->size] = job;
+    h->pos[job] = h->size;
+    sift_up(h, h->size++);
+}
+
+int jheap_pop(JobHeap *h) {
+    if (h->size == 0) return -1;
+    int top = h->heap[0];
+    h->pos[top] = -1;
+    if (--h->size > 0) {
+        h->heap[0] = h->heap[h->size];
+        sift_down(h, 0);
+    }
+    return top;
+}
+
+void jheap_update(JobHeap *h, int job) {
+    int slot = h->pos[job];
+    if (slot < 0) return;
+    sift_up(h, slot);
+    sift_down(h, h->pos[job]);
+}
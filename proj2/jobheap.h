@@ -0,0 +1,33 @@
+#ifndef JOBHEAP_H
+#define JOBHEAP_H
+
+#include "scheduler.h"
+
+// --- Indexed Binary Heap of Jobs ---
+// Min-heap of job indices ordered by a policy comparator. 'pos' maps each job
+// to its slot so a job whose key changed (aging, remaining time) can be
+// re-sifted in O(log n) without searching for it.
+
+typedef bool (*JobLess)(const void *ctx, int a, int b);
+
+typedef struct {
+    int *heap;          // job indices, heap[0] is the minimum
+    int *pos;           // pos[job] = slot in heap, -1 when absent
+    int size;
+    const void *ctx;    // passed to 'less' (the policy's engine)
+    JobLess less;
+} JobHeap;
+
+void jheap_init(JobHeap *h, const void *ctx, int count, JobLess less);
+void jheap_free(JobHeap *h);
+// Independent copy of 'src' (built for 'count' jobs) comparing through 'ctx'
+void jheap_copy(JobHeap *dst, const JobHeap *src, const void *ctx, int count);
+
+void jheap_push(JobHeap *h, int job);
+int  jheap_pop(JobHeap *h);                 // -1 when empty
+void jheap_update(JobHeap *h, int job);     // job's key changed in place
+
+static inline bool jheap_contains(const JobHeap *h, int job) { return h->pos[job] >= 0; }
+static inline int  jheap_peek(const JobHeap *h) { return h->size ? h->heap[0] : -1; }
+
+#endif
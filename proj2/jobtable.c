@@ -0,0 +1,145 @@
+#include <string.h>
+#include "jobtable.h"
+
+// i386 only has SSE2 when built for it (-msse2); otherwise it uses the scalar scan
+#if (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))) && !defined(JT_SCALAR)
+#include <immintrin.h>
+#define JT_SIMD 1
+#endif
+
+void jtable_init(JobTable *t, int count) {
+    if (count < 1) count = 1;
+    t->key = xmalloc(sizeof(int) * count);
+    t->unstarted = xmalloc(sizeof(int) * count);
+    for (int i = 0; i < count; i++) t->key[i] = JT_NONE;
+    memset(t->unstarted, 0xff, sizeof(int) * count);
+    t->lo = t->hi = 0;
+}
+
+void jtable_free(JobTable *t) {
+    free(t->key);
+    free(t->unstarted);
+    t->key = t->unstarted = NULL;
+}
+
+void jtable_copy(JobTable *dst, const JobTable *src, int count) {
+    if (count < 1) count = 1;
+    *dst = *src;
+    dst->key = xmemdup(src->key, sizeof(int) * count);
+    dst->unstarted = xmemdup(src->unstarted, sizeof(int) * count);
+}
+
+void jtable_put(JobTable *t, int job, int key) {
+    t->key[job] = key;
+    if (job < t->lo) t->lo = job;
+    if (job >= t->hi) t->hi = job + 1;
+}
+
+// --- Min-Scan Kernels ---
+// Each returns the smallest masked key in [lo, hi) and the lowest index that
+// holds it (-1 if every entry is masked). The vector kernels keep a running
+// minimum per lane, replaced only on a strictly smaller key, so each lane
+// remembers its earliest index; the final lane merge breaks key ties by
+// index, which makes them agree with the scalar loop exactly.
+
+typedef struct {
+    int key;
+    int job;
+} Best;
+
+static Best scan_scalar(const int *key, const int *unstarted, int lo, int hi, bool started_only) {
+    Best b = { JT_NONE, -1 };
+    for (int i = lo; i < hi; i++) {
+        int k = (started_only && unstarted[i]) ? JT_NONE : key[i];
+        if (k < b.key) {
+            b.key = k;
+            b.job = i;
+        }
+    }
+    return b;
+}
+
+#ifdef JT_SIMD
+static Best merge_lanes(const int *lane_key, const int *lane_job, int lanes, Best tail) {
+    Best b = { JT_NONE, -1 };
+    for (int l = 0; l < lanes; l++) {
+        if (lane_job[l] < 0) continue;
+        if (lane_key[l] < b.key || (lane_key[l] == b.key && lane_job[l] < b.job)) {
+            b.key = lane_key[l];
+            b.job = lane_job[l];
+        }
+    }
+    // The scalar tail only holds later indices, so it must be strictly smaller
+    return tail.key < b.key ? tail : b;
+}
+
+// SSE2 is part of the x86-64 baseline, and guaranteed on i386 by __SSE2__
+static Best scan_sse2(const int *key, const int *unstarted, int lo, int hi, bool started_only) {
+    const __m128i none = _mm_set1_epi32(JT_NONE);
+    const __m128i step = _mm_set1_epi32(4);
+    __m128i best = none;
+    __m128i best_job = _mm_set1_epi32(-1);
+    __m128i idx = _mm_setr_epi32(lo, lo + 1, lo + 2, lo + 3);
+    int i = lo;
+    for (; i + 4 <= hi; i += 4) {
+        __m128i k = _mm_loadu_si128((const __m128i *)(key + i));
+        if (started_only) {
+            __m128i m = _mm_loadu_si128((const __m128i *)(unstarted + i));
+            k = _mm_or_si128(_mm_and_si128(m, none), _mm_andnot_si128(m, k));
+        }
+        __m128i lt = _mm_cmplt_epi32(k, best);
+        best = _mm_or_si128(_mm_and_si128(lt, k), _mm_andnot_si128(lt, best));
+        best_job = _mm_or_si128(_mm_and_si128(lt, idx), _mm_andnot_si128(lt, best_job));
+        idx = _mm_add_epi32(idx, step);
+    }
+    int lane_key[4], lane_job[4];
+    _mm_storeu_si128((__m128i *)lane_key, best);
+    _mm_storeu_si128((__m128i *)lane_job, best_job);
+    return merge_lanes(lane_key, lane_job, 4, scan_scalar(key, unstarted, i, hi, started_only));
+}
+
+__attribute__((target("avx2")))
+static Best scan_avx2(const int *key, const int *unstarted, int lo, int hi, bool started_only) {
+    const __m256i none = _mm256_set1_epi32(JT_NONE);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i best = none;
+    __m256i best_job = _mm256_set1_epi32(-1);
+    __m256i idx = _mm256_add_epi32(_mm256_set1_epi32(lo), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    int i = lo;
+    for (; i + 8 <= hi; i += 8) {
+        __m256i k = _mm256_loadu_si256((const __m256i *)(key + i));
+        if (started_only) {
+            __m256i m = _mm256_loadu_si256((const __m256i *)(unstarted + i));
+            k = _mm256_blendv_epi8(k, none, m);
+        }
+        __m256i lt = _mm256_cmpgt_epi32(best, k);
+        best = _mm256_blendv_epi8(best, k, lt);
+        best_job = _mm256_blendv_epi8(best_job, idx, lt);
+        idx = _mm256_add_epi32(idx, step);
+    }
+    int lane_key[8], lane_job[8];
+    _mm256_storeu_si256((__m256i *)lane_key, best);
+    _mm256_storeu_si256((__m256i *)lane_job, best_job);
+    return merge_lanes(lane_key, lane_job, 8, scan_scalar(key, unstarted, i, hi, started_only));
+}
+#endif
+
+static Best scan(const JobTable *t, bool started_only) {
+#ifdef JT_SIMD
+    if (__builtin_cpu_supports("avx2")) return scan_avx2(t->key, t->unstarted, t->lo, t->hi, started_only);
+    return scan_sse2(t->key, t->unstarted, t->lo, t->hi, started_only);
+#else
+    return scan_scalar(t->key, t->unstarted, t->lo, t->hi, started_only);
+#endif
+}
+
+int jtable_pop(JobTable *t, bool started_only) {
+    Best b = scan(t, started_only);
+    if (b.job < 0) return -1;
+
+    t->key[b.job] = JT_NONE;
+    t->unstarted[b.job] = 0;
+    // Shrink the window past entries that can never be picked again
+    while (t->lo < t->hi && (t->key[t->lo] == JT_NONE || (started_only && t->unstarted[t->lo]))) t->lo++;
+    return b.job;
+}
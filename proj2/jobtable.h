@@ -0,0 +1,36 @@
+#ifndef JOBTABLE_H
+#define JOBTABLE_H
+
+#include <limits.h>
+#include "scheduler.h"
+
+// --- Structure-of-Arrays Ready Table ---
+// Alternative to JobHeap for dense traces: each job keeps its policy key in
+// a flat column and selection is a SIMD min-scan over the arrived window
+// [lo, hi) instead of heap maintenance on every arrival and aging step.
+// Ties go to the lowest job index, which in an arrival-sorted array with
+// ids increasing in index order is the heaps' (arrival, id) tie-break.
+
+#define JT_NONE INT_MAX     // key of a job that is not ready
+
+typedef struct {
+    int *key;           // policy key (remaining time, priority...), JT_NONE if not ready
+    int *unstarted;     // all ones until the job is first popped, then 0 (a ready-made lane mask)
+    int lo, hi;         // every ready job lies in [lo, hi); hi = jobs arrived so far
+} JobTable;
+
+void jtable_init(JobTable *t, int count);
+void jtable_free(JobTable *t);
+void jtable_copy(JobTable *dst, const JobTable *src, int count);
+
+// Marks 'job' ready with 'key' (< JT_NONE); arrivals must come in index order
+void jtable_put(JobTable *t, int job, int key);
+
+// Removes and returns the ready job with the smallest (key, index), -1 if none.
+// With 'started_only' (past the start cutoff) unstarted jobs are masked out
+// and left behind for good, since the engine would drop them anyway.
+int jtable_pop(JobTable *t, bool started_only);
+
+static inline bool jtable_contains(const JobTable *t, int job) { return t->key[job] != JT_NONE; }
+
+#endif
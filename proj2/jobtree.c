@@ -0,0 +1,220 @@
+#include "jobtree.h"
+
+void jtree_init(JobTree *t, int count) {
+    if (count < 1) count = 1;
+    int slots = count + 1;
+    t->left = xmalloc(sizeof(int) * slots);
+    t->right = xmalloc(sizeof(int) * slots);
+    t->parent = xmalloc(sizeof(int) * slots);
+    t->red = xcalloc(slots, 1);
+    t->key = xcalloc(slots, sizeof(int64_t));
+    t->nil = count;
+    t->root = t->first = t->nil;
+    t->left[t->nil] = t->right[t->nil] = t->parent[t->nil] = t->nil;
+    t->size = 0;
+}
+
+void jtree_free(JobTree *t) {
+    free(t->left);
+    free(t->right);
+    free(t->parent);
+    free(t->red);
+    free(t->key);
+    t->left = t->right = t->parent = NULL;
+    t->red = NULL;
+    t->key = NULL;
+    t->size = 0;
+}
+
+void jtree_copy(JobTree *dst, const JobTree *src) {
+    int slots = src->nil + 1;
+    *dst = *src;
+    dst->left = xmemdup(src->left, sizeof(int) * slots);
+    dst->right = xmemdup(src->right, sizeof(int) * slots);
+    dst->parent = xmemdup(src->parent, sizeof(int) * slots);
+    dst->red = xmemdup(src->red, slots);
+    dst->key = xmemdup(src->key, sizeof(int64_t) * slots);
+}
+
+static bool less(const JobTree *t, int a, int b) {
+    if (t->key[a] != t->key[b]) return t->key[a] < t->key[b];
+    return a < b;
+}
+
+static void rotate_left(JobTree *t, int x) {
+    int y = t->right[x];
+    t->right[x] = t->left[y];
+    if (t->left[y] != t->nil) t->parent[t->left[y]] = x;
+    t->parent[y] = t->parent[x];
+    if (t->parent[x] == t->nil) t->root = y;
+    else if (x == t->left[t->parent[x]]) t->left[t->parent[x]] = y;
+    else t->right[t->parent[x]] = y;
+    t->left[y] = x;
+    t->parent[x] = y;
+}
+
+static void rotate_right(JobTree *t, int x) {
+    int y = t->left[x];
+    t->left[x] = t->right[y];
+    if (t->right[y] != t->nil) t->parent[t->right[y]] = x;
+    t->parent[y] = t->parent[x];
+    if (t->parent[x] == t->nil) t->root = y;
+    else if (x == t->right[t->parent[x]]) t->right[t->parent[x]] = y;
+    else t->left[t->parent[x]] = y;
+    t->right[y] = x;
+    t->parent[x] = y;
+}
+
+void jtree_insert(JobTree *t, int z, int64_t key) {
+    t->key[z] = key;
+    int y = t->nil, x = t->root;
+    while (x != t->nil) {
+        y = x;
+        x = less(t, z, x) ? t->left[x] : t->right[x];
+    }
+    t->parent[z] = y;
+    if (y == t->nil) t->root = z;
+    else if (less(t, z, y)) t->left[y] = z;
+    else t->right[y] = z;
+    t->left[z] = t->right[z] = t->nil;
+    t->red[z] = 1;
+    if (t->first == t->nil || less(t, z, t->first)) t->first = z;
+    t->size++;
+
+    // Restore the red-black properties
+    while (t->red[t->parent[z]]) {
+        int p = t->parent[z], g = t->parent[p];
+        if (p == t->left[g]) {
+            int u = t->right[g];
+            if (t->red[u]) {
+                t->red[p] = t->red[u] = 0;
+                t->red[g] = 1;
+                z = g;
+                continue;
+            }
+            if (z == t->right[p]) {
+                z = p;
+                rotate_left(t, z);
+                p = t->parent[z];
+            }
+            t->red[p] = 0;
+            t->red[g] = 1;
+            rotate_right(t, g);
+        } else {
+            int u = t->left[g];
+            if (t->red[u]) {
+                t->red[p] = t->red[u] = 0;
+                t->red[g] = 1;
+                z = g;
+                continue;
+            }
+            if (z == t->left[p]) {
+                z = p;
+                rotate_right(t, z);
+                p = t->parent[z];
+            }
+            t->red[p] = 0;
+            t->red[g] = 1;
+            rotate_left(t, g);
+        }
+    }
+    t->red[t->root] = 0;
+}
+
+static void transplant(JobTree *t, int u, int v) {
+    if (t->parent[u] == t->nil) t->root = v;
+    else if (u == t->left[t->parent[u]]) t->left[t->parent[u]] = v;
+    else t->right[t->parent[u]] = v;
+    t->parent[v] = t->parent[u];
+}
+
+static int subtree_min(const JobTree *t, int x) {
+    while (t->left[x] != t->nil) x = t->left[x];
+    return x;
+}
+
+void jtree_erase(JobTree *t, int z) {
+    // The leftmost job has no left child, so its successor is easy to find
+    if (z == t->first) t->first = t->right[z] != t->nil ? subtree_min(t, t->right[z]) : t->parent[z];
+
+    int y = z, x;
+    bool y_was_red = t->red[y];
+    if (t->left[z] == t->nil) {
+        x = t->right[z];
+        transplant(t, z, x);
+    } else if (t->right[z] == t->nil) {
+        x = t->left[z];
+        transplant(t, z, x);
+    } else {
+        y = subtree_min(t, t->right[z]);
+        y_was_red = t->red[y];
+        x = t->right[y];
+        if (t->parent[y] == z) t->parent[x] = y;
+        else {
+            transplant(t, y, x);
+            t->right[y] = t->right[z];
+            t->parent[t->right[y]] = y;
+        }
+        transplant(t, z, y);
+        t->left[y] = t->left[z];
+        t->parent[t->left[y]] = y;
+        t->red[y] = t->red[z];
+    }
+    t->size--;
+    if (y_was_red) return;
+
+    // Restore the red-black properties
+    while (x != t->root && !t->red[x]) {
+        int p = t->parent[x];
+        if (x == t->left[p]) {
+            int w = t->right[p];
+            if (t->red[w]) {
+                t->red[w] = 0;
+                t->red[p] = 1;
+                rotate_left(t, p);
+                w = t->right[p];
+            }
+            if (!t->red[t->left[w]] && !t->red[t->right[w]]) {
+                t->red[w] = 1;
+                x = p;
+            } else {
+                if (!t->red[t->right[w]]) {
+                    t->red[t->left[w]] = 0;
+                    t->red[w] = 1;
+                    rotate_right(t, w);
+                    w = t->right[p];
+                }
+                t->red[w] = t->red[p];
+                t->red[p] = 0;
+                t->red[t->right[w]] = 0;
+                rotate_left(t, p);
+                x = t->root;
+            }
+        } else {
+            int w = t->left[p];
+            if (t->red[w]) {
+                t->red[w] = 0;
+                t->red[p] = 1;
+                rotate_right(t, p);
+                w = t->left[p];
+            }
+            if (!t->red[t->right[w]] && !t->red[t->left[w]]) {
+                t->red[w] = 1;
+                x = p;
+            } else {
+                if (!t->red[t->left[w]]) {
+                    t->red[t->right[w]] = 0;
+                    t->red[w] = 1;
+                    rotate_left(t, w);
+                    w = t->left[p];
+                }
+                t->red[w] = t->red[p];
+                t->red[p] = 0;
+                t->red[t->left[w]] = 0;
+                rotate_right(t, p);
+                x = t->root;
+            }
+        }
+    }
+    t->red[x] = 0;
+}
@@ -0,0 +1,33 @@
+#ifndef JOBTREE_H
+#define JOBTREE_H
+
+#include <stdint.h>
+#include "scheduler.h"
+
+// --- Red-Black Tree of Jobs ---
+// Balanced search tree over job indices ordered by (key, index), with the
+// node links stored in per-job arrays. Insert and erase are O(log n) and
+// the leftmost job is cached, so peeking the minimum is O(1). A job's key
+// stays readable in 'key' after it is erased.
+
+typedef struct {
+    int *left, *right, *parent;
+    unsigned char *red;
+    int64_t *key;
+    int nil;            // sentinel slot past the last job
+    int root;
+    int first;          // leftmost job, nil when empty
+    int size;
+} JobTree;
+
+void jtree_init(JobTree *t, int count);
+void jtree_free(JobTree *t);
+void jtree_copy(JobTree *dst, const JobTree *src);
+
+void jtree_insert(JobTree *t, int job, int64_t key);
+void jtree_erase(JobTree *t, int job);
+
+static inline bool jtree_empty(const JobTree *t) { return t->size == 0; }
+static inline int  jtree_first(const JobTree *t) { return t->size ? t->first : -1; }
+
+#endif
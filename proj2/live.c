@@ -0,0 +1,211 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include "live.h"
+
+#define SPIN_NS 100000  // below this much CPU left in a slice, stop sleeping and poll
+
+// Shared with one child; the child rewrites seen and cpu on every spin, the
+// dispatcher sets limit and last before each SIGCONT
+typedef struct {
+    _Atomic int64_t seen;   // CLOCK_MONOTONIC ns of its latest spin
+    _Atomic int64_t cpu;    // its CPU time so far, ns
+    _Atomic int64_t limit;  // CPU time at which the current slice ends
+    _Atomic int last;       // the current slice is the job's last
+} LiveSlot;
+
+static int64_t clock_ns(clockid_t clk) {
+    struct timespec ts;
+    clock_gettime(clk, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void sleep_until(int64_t t) {
+    struct timespec ts = { .tv_sec = t / 1000000000, .tv_nsec = t % 1000000000 };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+}
+
+// Child: parks until first dispatched, then burns CPU up to each slice's
+// limit. It parks itself at the end of a slice, so an overrun can never
+// eat into the next one, and exits only at the end of the last.
+static void child_main(LiveSlot *slot, int core) {
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (core >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+    raise(SIGSTOP);
+    for (;;) {
+        atomic_store_explicit(&slot->seen, clock_ns(CLOCK_MONOTONIC), memory_order_release);
+        int64_t used = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+        atomic_store_explicit(&slot->cpu, used, memory_order_release);
+        if (used < atomic_load_explicit(&slot->limit, memory_order_acquire)) continue;
+        if (atomic_load_explicit(&slot->last, memory_order_acquire)) _exit(0);
+        raise(SIGSTOP);
+    }
+}
+
+// True once 'pid' has exited (and is reaped); stops are not reported
+static bool child_gone(pid_t pid) {
+    return kill(pid, 0) < 0 || waitpid(pid, NULL, WNOHANG) == pid;
+}
+
+// Blocks until the child has had 'target' ns of CPU; false if it died first
+static bool wait_cpu(pid_t pid, LiveSlot *slot, int64_t target) {
+    for (;;) {
+        int64_t left = target - atomic_load_explicit(&slot->cpu, memory_order_acquire);
+        if (left <= 0) return true;
+        if (child_gone(pid)) return false;
+        if (left > SPIN_NS) sleep_until(clock_ns(CLOCK_MONOTONIC) + left - SPIN_NS);
+        else sched_yield(); // the dispatcher may share the children's core
+    }
+}
+
+// SIGCONT to 'pid' for a slice ending at 'limit' ns of CPU; returns when
+// the child is seen running, or -1 if it has died
+static int64_t resume(pid_t pid, LiveSlot *slot, int64_t limit, bool last, int64_t *sent) {
+    atomic_store_explicit(&slot->limit, limit, memory_order_release);
+    atomic_store_explicit(&slot->last, last, memory_order_release);
+    *sent = clock_ns(CLOCK_MONOTONIC);
+    if (kill(pid, SIGCONT) < 0) return -1;
+    int64_t seen;
+    while ((seen = atomic_load_explicit(&slot->seen, memory_order_acquire)) < *sent) {
+        if (child_gone(pid)) return -1;
+        sched_yield();
+    }
+    return seen;
+}
+
+static void kill_all(pid_t *pid, int count) {
+    for (int i = 0; i < count; i++) {
+        if (pid[i] <= 0) continue;
+        kill(pid[i], SIGKILL);
+        waitpid(pid[i], NULL, 0);
+    }
+}
+
+bool live_run(const JobSpec *spec, const JobState *sim, int count, const SegmentLog *log, const LiveOptions *opt,
+              LiveResult *res) {
+    memset(res, 0, sizeof(LiveResult));
+    if (count > LIVE_MAX_JOBS) {
+        fprintf(stderr, "Live mode runs at most %d jobs (workload has %d)\n", LIVE_MAX_JOBS, count);
+        return false;
+    }
+    int64_t q = (int64_t)opt->quantum_us * 1000;
+    size_t n = count > 0 ? count : 1;
+    LiveSlot *slot = mmap(NULL, sizeof(LiveSlot) * n, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (slot == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+    pid_t *pid = xcalloc(n, sizeof(pid_t));
+    int *served = xcalloc(n, sizeof(int));          // quanta replayed so far
+    int64_t *finish = xcalloc(n, sizeof(int64_t));
+    fflush(NULL); // children must not flush the parent's buffers
+
+    // Only jobs the simulation completed appear in the log
+    for (int i = 0; i < count; i++) {
+        if (sim[i].finish_time <= 0) continue;
+        pid[i] = fork();
+        if (pid[i] == 0) child_main(&slot[i], opt->core);
+        if (pid[i] < 0) {
+            perror("fork");
+            kill_all(pid, i);
+            free(pid);
+            free(served);
+            free(finish);
+            munmap(slot, sizeof(LiveSlot) * n);
+            return false;
+        }
+        waitpid(pid[i], NULL, WUNTRACED); // parked on its own SIGSTOP
+    }
+
+    int64_t t0 = clock_ns(CLOCK_MONOTONIC);
+    int64_t freed = t0;     // when the CPU was last released
+    int last_end = -1;      // simulated end of the previous segment
+    for (int s = 0; s < log->count; s++) {
+        const Segment *seg = &log->seg[s];
+        int job = seg->job;
+        int64_t start = t0 + seg->start * q;
+        if (freed < start) sleep_until(start); // idle in the schedule too
+
+        if (pid[job] <= 0) continue; // died early; its finish is recorded
+
+        served[job] += seg->end - seg->start;
+        int64_t target = served[job] * q;
+        bool last = served[job] >= spec[job].run_time;
+        int64_t sent;
+        int64_t running = resume(pid[job], &slot[job], target, last, &sent);
+        bool back_to_back = seg->start == last_end;
+        last_end = seg->end;
+        if (running < 0) {
+            // Should not happen: a child only exits during its last slice
+            pid[job] = 0;
+            freed = finish[job] = clock_ns(CLOCK_MONOTONIC);
+            continue;
+        }
+        hist_record(&res->dispatch_ns, (int)(running - sent));
+        if (back_to_back) hist_record(&res->switch_ns, (int)(running - freed));
+        res->dispatches++;
+
+        if (last) {
+            // Last slice: the child exits once its budget is spent
+            waitpid(pid[job], NULL, 0);
+            pid[job] = 0;
+            freed = finish[job] = clock_ns(CLOCK_MONOTONIC);
+            continue;
+        }
+        // The child parks itself at 'target'. The SIGSTOP is redundant
+        // unless it is between its last check and raise(); either way
+        // waitpid sees exactly one stop.
+        bool alive = wait_cpu(pid[job], &slot[job], target);
+        freed = clock_ns(CLOCK_MONOTONIC);
+        int status = 0;
+        if (alive) {
+            kill(pid[job], SIGSTOP);
+            alive = waitpid(pid[job], &status, WUNTRACED) == pid[job] && WIFSTOPPED(status);
+        }
+        if (!alive) {
+            pid[job] = 0;
+            finish[job] = freed;
+            continue;
+        }
+        hist_record(&res->stop_ns, (int)(clock_ns(CLOCK_MONOTONIC) - freed));
+        hist_record(&res->overrun_ns, (int)(atomic_load(&slot[job].cpu) - target));
+    }
+    kill_all(pid, count); // only left if the log did not cover a job
+
+    double sim_tat = 0, live_tat = 0, sim_wait = 0, live_wait = 0;
+    for (int i = 0; i < count; i++) {
+        if (finish[i] == 0) continue;
+        int tat = sim[i].finish_time - spec[i].arrival_time;
+        double real = (double)(finish[i] - (t0 + spec[i].arrival_time * q)) / q;
+        sim_tat += tat;
+        sim_wait += tat - spec[i].run_time;
+        live_tat += real;
+        live_wait += real - spec[i].run_time;
+        res->jobs++;
+    }
+    if (res->jobs > 0) {
+        res->sim_tat = sim_tat / res->jobs;
+        res->live_tat = live_tat / res->jobs;
+        res->sim_wait = sim_wait / res->jobs;
+        res->live_wait = live_wait / res->jobs;
+    }
+
+    free(pid);
+    free(served);
+    free(finish);
+    munmap(slot, sizeof(LiveSlot) * n);
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef LIVE_H
+#define LIVE_H
+
+#include "scheduler.h"
+#include "hist.h"
+
+// --- Live Replay ---
+// Plays a simulated schedule back with real processes. Every job becomes a
+// forked child that burns run_time quanta of CPU time, pinned with the
+// others to one core, and the dispatcher enforces the simulated segment
+// order with SIGCONT/SIGSTOP. Segments start no earlier than their
+// simulated time but never before the previous one has really stopped, so
+// every cost the simulator treats as zero (signal delivery, stopping, the
+// kernel's own switch) shows up as drift in the live turnaround.
+
+#define LIVE_MAX_JOBS 512   // children alive at once
+
+typedef struct {
+    int quantum_us;     // wall-clock length of one quantum
+    int core;           // CPU the children are pinned to, -1 = anywhere
+} LiveOptions;
+
+typedef struct {
+    int jobs;               // completed jobs
+    double sim_tat, live_tat;   // averages, in quanta
+    double sim_wait, live_wait;
+    long dispatches;
+    Hist dispatch_ns;       // SIGCONT sent -> child seen running
+    Hist stop_ns;           // SIGSTOP sent -> stop reported by waitpid
+    Hist switch_ns;         // CPU released -> next job running, back-to-back segments only
+    Hist overrun_ns;        // CPU a preempted child got past the end of its slice
+} LiveResult;
+
+// Replays 'log' (one CPU, from a run of spec[0..count) that left 'sim').
+// Children are forked and stopped before the clock starts, so fork costs
+// are not measured. Prints the reason and returns false on failure.
+bool live_run(const JobSpec *spec, const JobState *sim, int count, const SegmentLog *log, const LiveOptions *opt,
+              LiveResult *res);
+
+#endif
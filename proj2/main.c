@@ -2,120 +2,185 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <limits.h>
+#include <math.h>
 #include "scheduler.h"
+#include "engine.h"
+#include "pool.h"
+#include "rng.h"
+#include "trace.h"
+#include "hist.h"
+#include "gantt.h"
+#include "arena.h"
+#include "live.h"
 
 #define INITIAL_JOB_COUNT 10
 #define MAX_IDLE_ALLOWANCE 2
 #define NUM_RUNS 5
+#define NUM_ALGOS 9
+#define BATCH_RUNS 1024 // runs simulated between two in-order reductions
+#define CI_MIN_RUNS 10  // -ci: runs before an interval is trusted, and the smallest top-up
+#define CI_MAX_RUNS 100000 // -ci: default run cap
+
+#define MEAN_GAP 4.5 // mean inter-arrival; ~22 jobs per 100 quanta, as the old retry loop settled on
+
+// Quiet mode: per-job latency distributions instead of per-job text
+enum { METRIC_TAT, METRIC_WAIT, METRIC_RESP, NUM_METRICS };
+#define NUM_CLASSES 5 // [0] = all jobs, [1..4] = initial priority
+
+typedef struct {
+    Hist h[NUM_METRICS][NUM_CLASSES];
+} TailStats;
+
+// Tuning knobs, set per run on the command line instead of at compile time.
+// A sweep runs every combination of their ranges.
+typedef struct {
+    int quantum;        // RR time slice
+    int aging_limit;    // HPF: quanta at one level before moving up
+    int max_idle;       // generator: longest the CPU may sit idle, quanta
+    int min_jobs;       // generator: fewest jobs when filling the default window
+} Knobs;
 
 // --- Helper Functions ---
 
-int compare_arrival(const void *a, const void *b) {
-    Process *p1 = (Process *)a;
-    Process *p2 = (Process *)b;
-    if (p1->arrival_time != p2->arrival_time) return p1->arrival_time - p2->arrival_time;
-    return p1->id - p2->id;
-}
+// Generate Run 1-10, Prio 1-4, arrivals in order over the workload horizon.
+// Single pass: each arrival follows the previous one by a uniform gap, and a job
+// that would leave the CPU idle for more than k->max_idle quanta is pulled
+// in, so the workload is valid by construction and never regenerated.
+//   count > 0:  exactly 'count' jobs, horizon stretched to keep the same load
+//   count == 0: keep adding jobs (at least k->min_jobs) until the
+//               TOTAL_QUANTA window is covered
+// With several CPUs the gaps are drawn in 1/cpus-quantum ticks and the idle
+// check runs against the pooled capacity, so every CPU sees the same load.
+// Draws from its own stream, so a seed yields the same workload on any thread.
+void generate_workload(Workload *w, int seed, int count, int cpus, const Knobs *k) {
+    Rng rng;
+    rng_seed(&rng, (uint64_t)seed, 0);
+    w->seed = (uint64_t)seed;
 
-void reset_processes(Process *dest, Process *src, int count) {
-    for (int i = 0; i < count; i++) {
-        dest[i] = src[i];
-        dest[i].remaining_time = src[i].run_time;
-        dest[i].start_time = -1;
-        dest[i].finish_time = 0;
-        // Reset history using the constant
-        for(int t=0; t<TOTAL_QUANTA; t++) dest[i].history[t] = false;
-        dest[i].waiting_time = 0;
-        dest[i].turnaround_time = 0;
-        dest[i].response_time = 0;
+    int horizon = TOTAL_QUANTA;
+    double mean_gap = MEAN_GAP; // in ticks
+    if (count > 0) {
+        if (count * MEAN_GAP / cpus > horizon) horizon = (int)(count * MEAN_GAP / cpus);
+        mean_gap = (double)horizon * cpus / count;
     }
-}
+    int max_gap = (int)(2 * mean_gap);
 
-// Ensure CPU is never idle for more than 2 consecutive quanta
-bool is_workload_valid(Process *procs, int count) {
-    int current_time = 0;
-    for (int i = 0; i < count; i++) {
-        if (procs[i].arrival_time > current_time) {
-            if (procs[i].arrival_time - current_time > MAX_IDLE_ALLOWANCE) return false;
-            current_time = procs[i].arrival_time;
+    int cap = count > 0 ? count : 2 * k->min_jobs + 1;
+    w->jobs = xmalloc(sizeof(JobSpec) * cap);
+    w->count = 0;
+
+    long tick = 0, busy_until = 0; // ticks; busy_until drains cpus ticks of work per quantum
+    for (int i = 0; count > 0 ? i < count : true; i++) {
+        tick += rng_range(&rng, max_gap + 1);
+        if (count == 0 && tick / cpus >= horizon && i >= k->min_jobs) break;
+
+        // Ensure CPU is never idle for more than max_idle consecutive quanta
+        if (tick > busy_until + (long)k->max_idle * cpus) tick = busy_until + (long)k->max_idle * cpus;
+        int arrival = (int)(tick / cpus);
+
+        if (i == cap) {
+            cap *= 2;
+            w->jobs = realloc(w->jobs, sizeof(JobSpec) * cap);
+            if (!w->jobs) {
+                fprintf(stderr, "Out of memory\n");
+                exit(1);
+            }
         }
-        current_time += procs[i].run_time;
+
+        JobSpec *job = &w->jobs[i];
+        job->id = i + 1;
+        job->name = (i < 26) ? ('A' + i) : '?';
+        job->arrival_time = arrival;
+        job->run_time = rng_range(&rng, 10) + 1;
+        job->priority = rng_range(&rng, 4) + 1; // 1-4
+        w->count++;
+
+        if (tick > busy_until) busy_until = tick;
+        busy_until += job->run_time;
     }
-    return true;
+
+    // Every job must arrive inside the window it can start in
+    if (w->count > 0 && w->jobs[w->count - 1].arrival_time >= horizon)
+        horizon = w->jobs[w->count - 1].arrival_time + 1;
+    w->horizon = horizon;
+    w->cutoff = horizon;
 }
 
-// Generate Arrival 0-99, Run 1-10, Prio 1-4
-int generate_workload(Process *workload, int seed) {
-    srand(seed);
-    int count = INITIAL_JOB_COUNT;
-    bool valid = false;
+void free_workload(Workload *w) {
+    free(w->jobs);
+    w->jobs = NULL;
+    w->count = 0;
+}
 
-    while (!valid) {
-        for (int i = 0; i < count; i++) {
-            workload[i].id = i + 1;
-            workload[i].name = (i < 26) ? ('A' + i) : '?';
-            workload[i].arrival_time = rand() % 100; // 0-99
-            workload[i].run_time = (rand() % 10) + 1;
-            workload[i].priority = (rand() % 4) + 1; // 1-4
-        }
-        qsort(workload, count, sizeof(Process), compare_arrival);
-        
-        if (is_workload_valid(workload, count)) valid = true;
-        else count++;
-    }
-    return count;
+// Original (pre-run) view of job i, from memory or from the stream
+static JobSpec workload_job(const Workload *w, int i) {
+    if (w->jobs) return w->jobs[i];
+    JobSpec spec = {0};
+    w->source->load(w->source, i, &spec);
+    return spec;
 }
 
-// Generates timeline only up to TOTAL_QUANTA (100) to respect array bounds
-int generate_timeline_string(Process *p, int count, char *buffer) {
+// Renders the segment log as one character per quantum ('_' = idle) into a
+// malloc'd string. It covers at least the horizon and runs on to the last
+// segment, so jobs finishing past the cutoff stay visible. With several CPUs
+// there is one "CPU<n>" row per CPU, separated by newlines.
+int generate_timeline_string(const JobSpec *spec, const JobState *st, int count, int horizon, int cpus, const SegmentLog *log,
+                             char **out) {
     int max_finish = 0;
     for (int i = 0; i < count; i++) {
-        if (p[i].finish_time > max_finish) max_finish = p[i].finish_time;
+        if (st[i].finish_time > max_finish) max_finish = st[i].finish_time;
     }
-    
-    // Fill buffer up to 100
-    for (int t = 0; t < TOTAL_QUANTA; t++) {
-        buffer[t] = '_';
-        for (int i = 0; i < count; i++) {
-            if (p[i].history[t]) {
-                buffer[t] = p[i].name;
-                break; 
-            }
-        }
+
+    int len = horizon;
+    for (int s = 0; s < log->count; s++) {
+        if (log->seg[s].end > len) len = log->seg[s].end;
     }
-    buffer[TOTAL_QUANTA] = '\0';
-    return max_finish;
-}
 
-void export_gantt_csv(const char* algo_name, int run_id, const char* time_chart) {
-    char filename[64];
-    sprintf(filename, "gantt_%s_run%d.csv", algo_name, run_id + 1);
-    FILE *f = fopen(filename, "w");
-    if (!f) return;
-    fprintf(f, "Job,Start,End\n");
-
-    char current = time_chart[0];
-    int start = 0;
-    for (int t = 1; t <= TOTAL_QUANTA; t++) {
-        char next = (t < TOTAL_QUANTA) ? time_chart[t] : 0;
-        if (next != current) {
-            if (current != ' ' && current != '_' && current != 0) {
-                fprintf(f, "%c,%d,%d\n", current, start, t);
-            }
-            current = next;
-            start = t;
+    if (cpus <= 1) {
+        char *buffer = xmalloc(len + 1);
+        memset(buffer, '_', len);
+        for (int s = 0; s < log->count; s++) {
+            memset(buffer + log->seg[s].start, spec[log->seg[s].job].name, log->seg[s].end - log->seg[s].start);
         }
+        buffer[len] = '\0';
+        *out = buffer;
+        return max_finish;
+    }
+
+    enum { LABEL = 8 }; // "CPU%-4d " prefix
+    size_t row = LABEL + len + 1;
+    char *buffer = xmalloc(row * cpus);
+    for (int c = 0; c < cpus; c++) {
+        char *r = buffer + row * c;
+        char label[16];
+        snprintf(label, sizeof(label), "CPU%-4d ", c % 10000);
+        memcpy(r, label, LABEL);
+        memset(r + LABEL, '_', len);
+        r[LABEL + len] = '\n';
+    }
+    for (int s = 0; s < log->count; s++) {
+        const Segment *seg = &log->seg[s];
+        memset(buffer + row * seg->cpu + LABEL + seg->start, spec[seg->job].name, seg->end - seg->start);
     }
-    fclose(f);
+    buffer[row * cpus - 1] = '\0';
+    *out = buffer;
+    return max_finish;
 }
 
 // Verbose output compliant with Source 39
-// UPDATED: Now takes 'original_workload' to calculate stats based on INITIAL priority
-void print_run_details(Process *p, Process *original_workload, int count, const char *algo_name, int run_id, const char *timeline, int actual_end_time) {
-    printf("Run #%d: %s\n", run_id + 1, algo_name);
-    printf("Timeline: %s\n", timeline);
-    printf("------------------------------------------------------------------------\n");
-    printf("%-5s %-9s %-9s %-9s %-9s %-9s %-9s\n", "Name", "Arrival", "Burst", "Prio", "TAT", "Wait", "Resp");
+// UPDATED: Now takes the original workload to calculate stats based on INITIAL priority
+// 'cpu' holds per-CPU counters when cpus > 1, NULL otherwise
+void print_run_details(FILE *out, const JobState *st, const Workload *w, const char *algo_name, int run_id, const char *timeline, int actual_end_time,
+                       const CpuStats *cpu, int cpus) {
+    int count = w->count;
+    int horizon = w->horizon;
+
+    fprintf(out, "Run #%d: %s\n", run_id + 1, algo_name);
+    if (cpus > 1) fprintf(out, "Timeline:\n%s\n", timeline);
+    else fprintf(out, "Timeline: %s\n", timeline);
+    fprintf(out, "------------------------------------------------------------------------\n");
+    fprintf(out, "%-5s %-9s %-9s %-9s %-9s %-9s %-9s\n", "Name", "Arrival", "Burst", "Prio", "TAT", "Wait", "Resp");
     
     double total_tat = 0, total_wait = 0, total_resp = 0;
     int executed = 0;
@@ -125,136 +190,899 @@ void print_run_details(Process *p, Process *original_workload, int count, const
     int q_count[5]={0};
 
     // Use max_finish_time for throughput calc
-    double actual_duration = (actual_end_time > TOTAL_QUANTA) ? (double)actual_end_time : (double)TOTAL_QUANTA;
+    double actual_duration = (actual_end_time > horizon) ? (double)actual_end_time : (double)horizon;
 
     for(int i=0; i<count; i++) {
-        // IMPORTANT: Use ORIGINAL priority for grouping (ignoring aging changes)
-        int initial_prio = original_workload[i].priority;
+        // IMPORTANT: Use ORIGINAL priority for grouping (ignoring aging changes).
+        // Streamed jobs that never arrived were never loaded, so print from the workload.
+        JobSpec spec = workload_job(w, i);
+        int initial_prio = spec.priority;
 
-        printf("%-5c %-9d %-9d %-9d ", p[i].name, p[i].arrival_time, p[i].run_time, initial_prio);
+        fprintf(out, "%-5c %-9d %-9d %-9d ", spec.name, spec.arrival_time, spec.run_time, initial_prio);
         
-        if (p[i].finish_time > 0) {
-            printf("%-9d %-9d %-9d\n", p[i].turnaround_time, p[i].waiting_time, p[i].response_time);
+        if (st[i].finish_time > 0) {
+            int tat = st[i].finish_time - spec.arrival_time;
+            int wait = tat - spec.run_time;
+            int resp = st[i].start_time - spec.arrival_time;
+            fprintf(out, "%-9d %-9d %-9d\n", tat, wait, resp);
             
-            total_tat += p[i].turnaround_time;
-            total_wait += p[i].waiting_time;
-            total_resp += p[i].response_time;
+            total_tat += tat;
+            total_wait += wait;
+            total_resp += resp;
             executed++;
             
             // Collect HPF stats based on INITIAL priority
             if(initial_prio >= 1 && initial_prio <= 4) {
-                q_tat[initial_prio] += p[i].turnaround_time;
-                q_wait[initial_prio] += p[i].waiting_time;
-                q_resp[initial_prio] += p[i].response_time;
+                q_tat[initial_prio] += tat;
+                q_wait[initial_prio] += wait;
+                q_resp[initial_prio] += resp;
                 q_count[initial_prio]++;
             }
         } else {
-             printf("[DROPPED]\n"); 
+             fprintf(out, "[DROPPED]\n"); 
         }
     }
     
     if (executed > 0) {
-        printf("------------------------------------------------------------------------\n");
-        printf("RUN SUMMARY: Avg TAT: %.2f | Avg Wait: %.2f | Avg Resp: %.2f | Throughput: %.2f\n",
+        fprintf(out, "------------------------------------------------------------------------\n");
+        fprintf(out, "RUN SUMMARY: Avg TAT: %.2f | Avg Wait: %.2f | Avg Resp: %.2f | Throughput: %.2f\n",
             total_tat/executed, total_wait/executed, total_resp/executed, (double)executed/actual_duration); 
     }
     
     if (strncmp(algo_name, "HPF", 3) == 0) {
-        printf("HPF QUEUE STATS (Based on Initial Priority):\n");
+        fprintf(out, "HPF QUEUE STATS (Based on Initial Priority):\n");
         for(int q=1; q<=4; q++) {
              if(q_count[q] > 0) {
-                 printf("  [P%d] Count: %d | Avg TAT: %.2f | Avg Wait: %.2f | Throughput: %.2f\n", 
+                 fprintf(out, "  [P%d] Count: %d | Avg TAT: %.2f | Avg Wait: %.2f | Throughput: %.2f\n", 
                      q, q_count[q], q_tat[q]/q_count[q], q_wait[q]/q_count[q], (double)q_count[q]/actual_duration); 
              } else {
-                 printf("  [P%d] Count: 0  | [STARVATION DETECTED]\n", q); 
+                 fprintf(out, "  [P%d] Count: 0  | [STARVATION DETECTED]\n", q); 
              }
         }
     }
-    printf("\n");
+
+    if (cpu) {
+        fprintf(out, "CPU STATS:\n");
+        for (int c = 0; c < cpus; c++) {
+            fprintf(out, "  [CPU%d] Util: %.2f%% | Migrations: %ld\n", c, 100.0 * cpu[c].busy / actual_duration, cpu[c].migrations);
+        }
+    }
+    fprintf(out, "\n");
 }
 
-void run_simulation_step(const char* name, int run_id, AlgoFunc func, Process* workload, int count, SimulationStats *stats, bool export_csv) {
-    Process p[MAX_JOBS];
-    reset_processes(p, workload, count);
-    
-    func(p, count); // Algorithm runs
+// Outcome of one (workload, algorithm) pair, kept until it is reduced in order
+typedef struct {
+    double avg_tat, avg_wait, avg_resp, throughput;
+    bool valid;
+    char *report;   // verbose text for this run, printed by the reducer
+    size_t report_len;
+    CpuStats *cpu;  // [cpus] when simulating several CPUs, freed by the reducer
+    double duration;
+    SegmentLog log; // kept for the Gantt export, 'job' holding job ids
+} RunResult;
+
+// Per-run settings that are the same for every task
+typedef struct {
+    bool report;    // build the per-run text (timeline and per-job table)
+    bool keep_log;  // hand the segment log to the reducer for the Gantt export
+    bool scan;      // SoA min-scan selection instead of heaps
+    int cpus;
+    int min_granularity; // CFS, 0 = default
+} RunOptions;
+
+// Feeds every completed job into 'tail' by its initial priority class
+static void record_tails(TailStats *tail, const JobSpec *spec, const JobState *st, int count) {
+    for (int i = 0; i < count; i++) {
+        if (st[i].finish_time <= 0) continue;
+        int prio = spec[i].priority;
+        int tat = st[i].finish_time - spec[i].arrival_time;
+        int v[NUM_METRICS] = { tat, tat - spec[i].run_time, st[i].start_time - spec[i].arrival_time };
+        for (int m = 0; m < NUM_METRICS; m++) {
+            hist_record(&tail->h[m][0], v[m]);
+            if (prio >= 1 && prio < NUM_CLASSES) hist_record(&tail->h[m][prio], v[m]);
+        }
+    }
+}
+
+// Fresh run state for every job of 'w', carved from 'arena'. *spec is set to
+// the specs the run reads: the workload's own, shared by every run, or (when
+// streamed) a buffer in the arena that the engine loads jobs into.
+static JobState *new_run(const Workload *w, SimParams *params, Arena *arena, const JobSpec **spec) {
+    int count = w->count;
+    size_t n = count > 0 ? count : 1;
+    JobState *st = arena_alloc(arena, sizeof(JobState) * n);
+    if (w->jobs) {
+        jobstate_init(st, w->jobs, count);
+        *spec = w->jobs;
+    } else {
+        // Streamed: jobs that never arrive must read as unfinished
+        memset(st, 0, sizeof(JobState) * n);
+        *spec = params->stream_specs = arena_alloc(arena, sizeof(JobSpec) * n);
+    }
+    return st;
+}
+
+static SimParams run_params(const Workload *w, const RunOptions *opt, const Knobs *knobs) {
+    return (SimParams){ .cutoff = w->cutoff, .source = w->source, .scan = opt->scan, .cpus = opt->cpus,
+                        .min_granularity = opt->min_granularity, .seed = w->seed,
+                        .quantum = knobs->quantum, .aging_limit = knobs->aging_limit };
+}
 
-    char time_chart[TOTAL_QUANTA + 1];
-    int actual_end_time = generate_timeline_string(p, count, time_chart);
-    if (actual_end_time < 100) actual_end_time = 100;
+static int last_finish(const JobState *st, int count) {
+    int end = 0;
+    for (int i = 0; i < count; i++) {
+        if (st[i].finish_time > end) end = st[i].finish_time;
+    }
+    return end;
+}
 
+// Fills in the run averages; 'end_time' is the span the throughput is
+// measured over
+static void summarize(const JobSpec *spec, const JobState *st, int count, int end_time, RunResult *res) {
     double sum_tat = 0, sum_wt = 0, sum_rt = 0;
     int completed = 0;
 
     for (int i = 0; i < count; i++) {
-        if (p[i].finish_time > 0) {
+        if (st[i].finish_time > 0) {
             completed++;
-            p[i].turnaround_time = p[i].finish_time - p[i].arrival_time;
-            p[i].waiting_time = p[i].turnaround_time - p[i].run_time;
-            p[i].response_time = p[i].start_time - p[i].arrival_time;
-
-            sum_tat += p[i].turnaround_time;
-            sum_wt += p[i].waiting_time;
-            sum_rt += p[i].response_time;
+            int tat = st[i].finish_time - spec[i].arrival_time;
+            sum_tat += tat;
+            sum_wt += tat - spec[i].run_time;
+            sum_rt += st[i].start_time - spec[i].arrival_time;
         }
     }
 
-    double actual_duration = (double)actual_end_time;
+    double actual_duration = (double)end_time;
+    res->duration = actual_duration;
 
+    res->valid = completed > 0;
     if (completed > 0) {
-        stats->total_turnaround += (sum_tat / completed);
-        stats->total_waiting += (sum_wt / completed);
-        stats->total_response += (sum_rt / completed);
-        stats->total_throughput += ((double)completed / actual_duration);
-        stats->valid_runs++;
+        res->avg_tat = sum_tat / completed;
+        res->avg_wait = sum_wt / completed;
+        res->avg_resp = sum_rt / completed;
+        res->throughput = (double)completed / actual_duration;
+    }
+}
+
+// Without opt->report the timeline and the per-job text are skipped; 'tail'
+// set = quiet mode: the job latencies are streamed into the histograms
+// 'arena' is the worker's scratch space; it is reset here, so nothing from
+// an earlier run may still point into it.
+void run_simulation_step(const char* name, int run_id, AlgoFunc func, Workload *w, RunResult *res, const RunOptions *opt,
+                         const Knobs *knobs, TailStats *tail, Arena *arena) {
+    int count = w->count;
+    SimParams params = run_params(w, opt, knobs);
+    const JobSpec *spec;
+    arena_reset(arena);
+    JobState *st = new_run(w, &params, arena, &spec);
+
+    res->cpu = NULL;
+    if (opt->cpus > 1) res->cpu = params.cpu_stats = xcalloc(opt->cpus, sizeof(CpuStats));
+    SegmentLog log = {0};
+    func(w->jobs, st, count, &params, &log); // Algorithm runs
+
+    char *time_chart = NULL;
+    int actual_end_time = 0;
+    if (!opt->report) {
+        actual_end_time = last_finish(st, count);
+    } else {
+        actual_end_time = generate_timeline_string(spec, st, count, w->horizon, opt->cpus, &log, &time_chart);
     }
+    if (actual_end_time < w->horizon) actual_end_time = w->horizon;
+    summarize(spec, st, count, actual_end_time, res);
 
-    // Pass 'workload' (original data) for correct stats grouping
-    print_run_details(p, workload, count, name, run_id, time_chart, actual_end_time);
+    if (tail) record_tails(tail, spec, st, count);
+    if (opt->report) {
+        // Pass the original workload for correct stats grouping
+        FILE *out = open_memstream(&res->report, &res->report_len);
+        if (!out) {
+            fprintf(stderr, "open_memstream failed\n");
+            exit(1);
+        }
+        print_run_details(out, st, w, name, run_id, time_chart, actual_end_time, res->cpu, opt->cpus);
+        fclose(out);
+    }
 
-    if (export_csv) {
-        export_gantt_csv(name, run_id, time_chart);
+    free(time_chart);
+    if (opt->keep_log) {
+        for (int s = 0; s < log.count; s++) log.seg[s].job = spec[log.seg[s].job].id;
+        res->log = log;
+    } else {
+        seglog_free(&log);
     }
 }
 
-int main(int argc, char *argv[]) {
-    bool enable_csv = false;
-    if (argc > 1 && strcmp(argv[1], "-csv") == 0) {
-        enable_csv = true;
+// --- Parallel Run Executor ---
+// Every (seed, algorithm) pair is an independent task. Results land in a
+// per-batch table and are folded into SimulationStats strictly in run order,
+// so the totals are bit-for-bit those of a single-threaded run.
+
+static const char* names[NUM_ALGOS] = {"FCFS", "SJF", "SRT", "RR", "HPF-NP", "HPF-Pre", "CFS", "Lottery", "Stride"};
+static AlgoFunc funcs[NUM_ALGOS] = {run_FCFS, run_SJF, run_SRT, run_RR, run_HPF_NonPreemptive, run_HPF_Preemptive, run_CFS, run_Lottery, run_Stride};
+typedef const SchedPolicy *(*PolicyFunc)(const SimParams *params);
+static PolicyFunc policies[NUM_ALGOS] = {policy_FCFS, policy_SJF, policy_SRT, policy_RR, policy_HPF_NonPreemptive,
+                                         policy_HPF_Preemptive, policy_CFS, policy_Lottery, policy_Stride};
+
+// Last workload a worker generated; consecutive tasks of a run reuse it.
+// The arena holds the job state of the worker's current task.
+typedef struct {
+    int unit;
+    Workload workload;
+    Arena arena;
+} WorkerCache;
+
+// Work is split into units, one per (sweep point, run); every unit runs each
+// algorithm once. Without a sweep there is one point and a unit is a run.
+typedef struct {
+    int base_seed;
+    int job_count;          // 0 = fill the default window
+    Workload *trace;        // replayed by every run instead of generating
+    const Knobs *points;    // sweep points, in table order
+    int num_runs;           // runs per point
+    int first_unit;
+    const int *task_map;    // -ci: unit * NUM_ALGOS + algo of each task, NULL = every algo of each unit
+    int switch_at;          // what-if mode: policies switch at this time, -1 = off
+    RunOptions opt;
+    RunResult *results;     // [task], what-if: [task][after]
+    WorkerCache *cache;     // one per worker
+    TailStats *tails;       // [worker][algo], quiet mode only
+} BatchCtx;
+
+// The workload of 'unit': the trace, or the worker's generated copy
+static Workload *task_workload(BatchCtx *ctx, int unit, int worker) {
+    if (ctx->trace) return ctx->trace;
+
+    // Every point sees the same seeds, so points differ only by their knobs
+    WorkerCache *wc = &ctx->cache[worker];
+    if (wc->unit != unit) {
+        free_workload(&wc->workload);
+        generate_workload(&wc->workload, ctx->base_seed + unit % ctx->num_runs, ctx->job_count, ctx->opt.cpus,
+                          &ctx->points[unit / ctx->num_runs]);
+        wc->unit = unit;
+    }
+    return &wc->workload;
+}
+
+// unit * NUM_ALGOS + algo of a task in the current batch
+static int task_id(const BatchCtx *ctx, int task) {
+    return ctx->task_map ? ctx->task_map[task] : ctx->first_unit * NUM_ALGOS + task;
+}
+
+static void run_task(void *arg, int task, int worker) {
+    BatchCtx *ctx = arg;
+    int unit = task_id(ctx, task) / NUM_ALGOS;
+    const Knobs *knobs = &ctx->points[unit / ctx->num_runs];
+    int run = unit % ctx->num_runs;
+    int algo = task_id(ctx, task) % NUM_ALGOS;
+    TailStats *tail = ctx->tails ? &ctx->tails[worker * NUM_ALGOS + algo] : NULL;
+
+    run_simulation_step(names[algo], run, funcs[algo], task_workload(ctx, unit, worker), &ctx->results[task], &ctx->opt,
+                        knobs, tail, &ctx->cache[worker].arena);
+}
+
+// --- What-If Branching ---
+// One task per (run, policy before the switch): the run is simulated up to
+// switch_at once, then that snapshot is forked into every policy, so the
+// whole before x after table costs one shared prefix per row.
+static void whatif_task(void *arg, int task, int worker) {
+    BatchCtx *ctx = arg;
+    int unit = task_id(ctx, task) / NUM_ALGOS;
+    const Knobs *knobs = &ctx->points[unit / ctx->num_runs];
+    int before = task % NUM_ALGOS;
+    Workload *w = task_workload(ctx, unit, worker);
+    int count = w->count;
+
+    SimParams params = run_params(w, &ctx->opt, knobs);
+    const JobSpec *spec;
+    Arena *arena = &ctx->cache[worker].arena;
+    arena_reset(arena);
+    JobState *st = new_run(w, &params, arena, &spec);
+    JobState *q = arena_alloc(arena, sizeof(JobState) * (count > 0 ? count : 1)); // every branch's state
+    SimEngine *prefix = engine_create(w->jobs, st, count, &params, policies[before](&params), NULL);
+    engine_advance(prefix, ctx->switch_at);
+
+    for (int after = 0; after < NUM_ALGOS; after++) {
+        RunResult *res = &ctx->results[task * NUM_ALGOS + after];
+        SimEngine *branch = engine_fork(prefix, q, NULL);
+        engine_switch(branch, policies[after](&params));
+        engine_advance(branch, INT_MAX);
+
+        SimParams out = params;
+        res->cpu = NULL;
+        if (ctx->opt.cpus > 1) res->cpu = out.cpu_stats = xcalloc(ctx->opt.cpus, sizeof(CpuStats));
+        engine_destroy(branch, &out);
+
+        int end = last_finish(q, count);
+        summarize(spec, q, count, end > w->horizon ? end : w->horizon, res);
+    }
+    engine_destroy(prefix, NULL);
+}
+
+static void accumulate(SimulationStats *stats, const RunResult *res, int cpus) {
+    if (!res->valid) return;
+    stats->total_turnaround += res->avg_tat;
+    stats->total_waiting += res->avg_wait;
+    stats->total_response += res->avg_resp;
+    stats->total_throughput += res->throughput;
+    stats->valid_runs++;
+    if (!res->cpu) return;
+    for (int c = 0; c < cpus; c++) {
+        stats->cpu_util[c] += res->cpu[c].busy / res->duration;
+        stats->cpu_migrations[c] += res->cpu[c].migrations;
     }
+}
 
-    const char* names[] = {"FCFS", "SJF", "SRT", "RR", "HPF-NP", "HPF-Pre"};
-    AlgoFunc funcs[] = {run_FCFS, run_SJF, run_SRT, run_RR, run_HPF_NonPreemptive, run_HPF_Preemptive};
-    SimulationStats stats[6] = {0};
+// Per-CPU utilization and migrations averaged over runs, one row per CPU
+static void print_cpu_table(const SimulationStats *stats, int cpus) {
+    printf("\n[==========] Per-CPU Util %% / Migrations (Average over runs) [==========]\n");
+    printf("%-7s", "CPU");
+    for (int a = 0; a < NUM_ALGOS; a++) printf(" %-15s", names[a]);
+    printf("\n");
+    for (int c = 0; c < cpus; c++) {
+        printf("%-7d", c);
+        for (int a = 0; a < NUM_ALGOS; a++) {
+            double div = stats[a].valid_runs > 0 ? stats[a].valid_runs : 1;
+            char cell[32];
+            snprintf(cell, sizeof(cell), "%.1f / %.2f", 100.0 * stats[a].cpu_util[c] / div, stats[a].cpu_migrations[c] / div);
+            printf(" %-15s", cell);
+        }
+        printf("\n");
+    }
+}
+
+// Percentiles of one metric for every algorithm and priority class
+static void print_tails(const char *title, const TailStats *tails, int metric) {
+    printf("\n%-10s %-6s %-10s %-9s %-9s %-9s %-9s\n", title, "Class", "Jobs", "P50", "P90", "P99", "Max");
+    printf("------------------------------------------------------------------\n");
+    for (int a = 0; a < NUM_ALGOS; a++) {
+        for (int c = 0; c < NUM_CLASSES; c++) {
+            const Hist *h = &tails[a].h[metric][c];
+            char cls[8];
+            if (c == 0) strcpy(cls, "all");
+            else sprintf(cls, "P%d", c);
+            if (h->total == 0) {
+                printf("%-10s %-6s %-10d [ NO DATA ]\n", c == 0 ? names[a] : "", cls, 0);
+                continue;
+            }
+            printf("%-10s %-6s %-10llu %-9d %-9d %-9d %-9d\n", c == 0 ? names[a] : "", cls,
+                (unsigned long long)h->total, hist_percentile(h, 50), hist_percentile(h, 90),
+                hist_percentile(h, 99), h->max);
+        }
+    }
+}
+
+// --- Live Replay ---
+// One workload (the first run's, or the trace) under every algorithm: each
+// schedule is simulated, then played back with real processes.
+
+// "p50/p99" of a latency histogram, in microseconds
+static void format_us(char *cell, size_t len, const Hist *h) {
+    if (h->total == 0) snprintf(cell, len, "-");
+    else snprintf(cell, len, "%.1f/%.1f", hist_percentile(h, 50) / 1000.0, hist_percentile(h, 99) / 1000.0);
+}
 
+static int run_live(Workload *w, const RunOptions *opt, const Knobs *knobs, int quantum_ms) {
+    LiveOptions lo = { .quantum_us = quantum_ms * 1000, .core = cpu_count() - 1 };
+    printf("[==========] Live Replay: %d jobs, %d ms quanta, children on CPU %d [==========]\n", w->count, quantum_ms,
+           lo.core);
+    printf("%-10s %-9s %-9s %-9s %-9s %-10s %-14s %-14s %-14s %-14s\n", "Algorithm", "Sim TAT", "Live TAT", "Sim Wait",
+           "Live Wait", "Dispatches", "Dispatch us", "Switch us", "Stop us", "Overrun us");
+    printf("%-10s %-9s %-9s %-9s %-9s %-10s %-14s %-14s %-14s %-14s\n", "", "(quanta)", "", "", "", "", "p50/p99",
+           "p50/p99", "p50/p99", "p50/p99");
+    printf("-------------------------------------------------------------------------------------------------------------------------\n");
+
+    Arena arena = {0};
+    LiveResult *res = xmalloc(sizeof(LiveResult));
+    int status = 0;
+    for (int a = 0; a < NUM_ALGOS && status == 0; a++) {
+        SimParams params = run_params(w, opt, knobs);
+        const JobSpec *spec;
+        arena_reset(&arena);
+        JobState *st = new_run(w, &params, &arena, &spec);
+        SegmentLog log = {0};
+        funcs[a](w->jobs, st, w->count, &params, &log);
+
+        if (!live_run(spec, st, w->count, &log, &lo, res)) status = 1;
+        else if (res->jobs == 0) printf("%-10s [ NO DATA ]\n", names[a]);
+        else {
+            char disp[32], sw[32], stop[32], over[32];
+            format_us(disp, sizeof(disp), &res->dispatch_ns);
+            format_us(sw, sizeof(sw), &res->switch_ns);
+            format_us(stop, sizeof(stop), &res->stop_ns);
+            format_us(over, sizeof(over), &res->overrun_ns);
+            printf("%-10s %-9.2f %-9.2f %-9.2f %-9.2f %-10ld %-14s %-14s %-14s %-14s\n", names[a], res->sim_tat,
+                   res->live_tat, res->sim_wait, res->live_wait, res->dispatches, disp, sw, stop, over);
+        }
+        fflush(stdout);
+        seglog_free(&log);
+    }
+    free(res);
+    arena_free(&arena);
+    return status;
+}
+
+// --- Adaptive Run Count ---
+// With -ci every algorithm keeps getting runs until the 95% confidence
+// interval of each reported average is at most +-width, or it hits the run
+// cap. Mean and variance are streamed (Welford) during the in-order
+// reduction, and the next batch is sized from the current interval, so the
+// outcome depends only on the seeds, never on the thread count.
+
+enum { CI_TAT, CI_WAIT, CI_RESP, CI_THROUGHPUT, NUM_CI };
+
+typedef struct {
+    long n;
+    double mean, m2;
+} Moments;
+
+typedef struct {
+    Moments m[NUM_CI];
+    int runs;           // reduced so far, including runs with no completed job
+    bool done;
+} CiState;
+
+static void moments_add(Moments *m, double x) {
+    m->n++;
+    double d = x - m->mean;
+    m->mean += d / m->n;
+    m->m2 += d * (x - m->mean);
+}
+
+// Two-sided 95% Student t quantile for 'df' degrees of freedom
+static double t95(long df) {
+    static const double table[30] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                      2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                      2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+    if (df <= 30) return table[df - 1];
+    const double z = 1.959964;
+    return z + (z * z * z + z) / (4.0 * df); // Cornish-Fisher, well within 0.001 past df 30
+}
+
+// Half-width of the 95% interval of the mean; infinite below two samples
+static double moments_ci(const Moments *m) {
+    if (m->n < 2) return INFINITY;
+    return t95(m->n - 1) * sqrt(m->m2 / (m->n - 1) / m->n);
+}
+
+static void ci_add(CiState *ci, const RunResult *res) {
+    ci->runs++;
+    if (!res->valid) return;
+    moments_add(&ci->m[CI_TAT], res->avg_tat);
+    moments_add(&ci->m[CI_WAIT], res->avg_wait);
+    moments_add(&ci->m[CI_RESP], res->avg_resp);
+    moments_add(&ci->m[CI_THROUGHPUT], res->throughput * 100.0); // as printed
+}
+
+// Lays out the next batch in ctx->task_map and returns its task count, 0
+// once every algorithm has converged or reached 'cap'. Each unfinished
+// algorithm gets the runs its interval projects it still needs (the width
+// shrinks as 1/sqrt(runs)), at least CI_MIN_RUNS and at most BATCH_RUNS.
+static int plan_ci_batch(CiState *ci, int *task_map, int cap, double width) {
+    int first = INT_MAX, last = 0;
+    int end[NUM_ALGOS];
+    for (int a = 0; a < NUM_ALGOS; a++) {
+        CiState *c = &ci[a];
+        double need = c->runs;
+        for (int m = 0; m < NUM_CI; m++) {
+            double ratio = moments_ci(&c->m[m]) / width;
+            if (ratio > 1) need = fmax(need, c->runs * ratio * ratio);
+        }
+        c->done = c->runs >= cap || (c->runs >= CI_MIN_RUNS && need <= c->runs);
+        end[a] = c->runs;
+        if (c->done) continue;
+
+        double want = need - c->runs;
+        if (want < CI_MIN_RUNS) want = CI_MIN_RUNS;
+        if (want > BATCH_RUNS) want = BATCH_RUNS;
+        end[a] = c->runs + (int)ceil(want);
+        if (end[a] > cap) end[a] = cap;
+        if (c->runs < first) first = c->runs;
+        if (end[a] > last) last = end[a];
+    }
+
+    // Unit-major, so a worker's cached workload serves several algorithms
+    int n = 0;
+    for (int u = first; u < last; u++) {
+        for (int a = 0; a < NUM_ALGOS; a++) {
+            if (u >= ci[a].runs && u < end[a]) task_map[n++] = u * NUM_ALGOS + a;
+        }
+    }
+    return n;
+}
+
+static void print_ci_table(const SimulationStats *stats, const CiState *ci, double width, int cap) {
+    printf("\n[==========] Final Statistics (mean +- 95%% CI, target +-%.2f, cap %d runs) [==========]\n", width, cap);
+    printf("%-10s %-8s %-16s %-16s %-16s %-16s\n", "Algorithm", "Runs", "Avg TAT", "Avg Wait", "Avg Resp", "Throughput");
+    printf("----------------------------------------------------------------------------------------\n");
+    for (int a = 0; a < NUM_ALGOS; a++) {
+        const SimulationStats *st = &stats[a];
+        if (st->valid_runs == 0) {
+            printf("%-10s %-8d [ NO DATA ]\n", names[a], ci[a].runs);
+            continue;
+        }
+        double div = st->valid_runs;
+        double mean[NUM_CI] = { st->total_turnaround / div, st->total_waiting / div, st->total_response / div,
+                                st->total_throughput / div * 100.0 };
+        bool converged = true;
+        char runs[16];
+        for (int m = 0; m < NUM_CI; m++) converged = converged && moments_ci(&ci[a].m[m]) <= width;
+        snprintf(runs, sizeof(runs), "%d%s", ci[a].runs, converged ? "" : "*");
+        printf("%-10s %-8s", names[a], runs);
+        for (int m = 0; m < NUM_CI; m++) {
+            char cell[32];
+            double hw = moments_ci(&ci[a].m[m]);
+            if (isfinite(hw)) snprintf(cell, sizeof(cell), "%.2f +-%.2f", mean[m], hw);
+            else snprintf(cell, sizeof(cell), "%.2f +-inf", mean[m]);
+            printf(" %-16s", cell);
+        }
+        printf("\n");
+    }
+    printf("* = stopped at the run cap before reaching the target\n");
+}
+
+// --- Parameter Sweep ---
+
+// Values lo, lo + step, ... up to hi
+typedef struct {
+    int lo, hi, step;
+} Range;
+
+// "N" or "LO:HI" or "LO:HI:STEP"
+static bool parse_range(const char *arg, Range *r) {
+    char *end;
+    r->lo = r->hi = (int)strtol(arg, &end, 10);
+    r->step = 1;
+    if (end == arg) return false;
+    if (*end == ':') r->hi = (int)strtol(end + 1, &end, 10);
+    if (*end == ':') r->step = (int)strtol(end + 1, &end, 10);
+    return *end == '\0' && r->step > 0 && r->hi >= r->lo;
+}
+
+static int range_len(const Range *r) { return (r->hi - r->lo) / r->step + 1; }
+
+enum { KNOB_QUANTUM, KNOB_AGING, KNOB_IDLE, KNOB_MIN_JOBS, NUM_KNOBS };
+
+// Cartesian product of the knob ranges, the last knob varying fastest
+static Knobs *build_points(const Range *ranges, int *count) {
+    int n = 1;
+    for (int k = 0; k < NUM_KNOBS; k++) n *= range_len(&ranges[k]);
+    Knobs *points = xmalloc(sizeof(Knobs) * n);
+    for (int i = 0; i < n; i++) {
+        int v[NUM_KNOBS];
+        int rest = i;
+        for (int k = NUM_KNOBS - 1; k >= 0; k--) {
+            int len = range_len(&ranges[k]);
+            v[k] = ranges[k].lo + (rest % len) * ranges[k].step;
+            rest /= len;
+        }
+        points[i] = (Knobs){ v[KNOB_QUANTUM], v[KNOB_AGING], v[KNOB_IDLE], v[KNOB_MIN_JOBS] };
+    }
+    *count = n;
+    return points;
+}
+
+// One row per (point, algorithm)
+static void print_sweep(const SimulationStats *stats, const Knobs *points, int num_points, int num_runs) {
+    printf("\n[==========] Parameter Sweep (%d points, average over %d runs each) [==========]\n", num_points, num_runs);
+    printf("%-8s %-6s %-8s %-8s %-10s %-12s %-12s %-12s %-12s\n",
+           "Quantum", "Aging", "MaxIdle", "MinJobs", "Algorithm", "Avg TAT", "Avg Wait", "Avg Resp", "Throughput");
+    printf("------------------------------------------------------------------------------------------------\n");
+    for (int pt = 0; pt < num_points; pt++) {
+        const Knobs *k = &points[pt];
+        for (int a = 0; a < NUM_ALGOS; a++) {
+            const SimulationStats *st = &stats[pt * NUM_ALGOS + a];
+            printf("%-8d %-6d %-8d %-8d %-10s ", k->quantum, k->aging_limit, k->max_idle, k->min_jobs, names[a]);
+            if (st->valid_runs == 0) {
+                printf("[ NO DATA ]\n");
+                continue;
+            }
+            double div = st->valid_runs;
+            printf("%-12.2f %-12.2f %-12.2f %-12.2f\n", st->total_turnaround / div, st->total_waiting / div,
+                   st->total_response / div, (st->total_throughput / div) * 100.0);
+        }
+    }
+}
+
+// Rows: policy before the switch, columns: policy after it
+static void print_whatif(const SimulationStats *stats, int switch_at, int num_runs) {
+    printf("\n[==========] What-If: Policy Switch at t=%d (Avg TAT / Avg Wait over %d runs) [==========]\n", switch_at, num_runs);
+    printf("%-16s", "Before \\ After");
+    for (int b = 0; b < NUM_ALGOS; b++) printf(" %-13s", names[b]);
+    printf("\n");
+    for (int a = 0; a < NUM_ALGOS; a++) {
+        printf("%-16s", names[a]);
+        for (int b = 0; b < NUM_ALGOS; b++) {
+            const SimulationStats *st = &stats[a * NUM_ALGOS + b];
+            char cell[32] = "[ NO DATA ]";
+            if (st->valid_runs > 0) {
+                snprintf(cell, sizeof(cell), "%.2f / %.2f", st->total_turnaround / st->valid_runs,
+                         st->total_waiting / st->valid_runs);
+            }
+            printf(" %-13s", cell);
+        }
+        printf("\n");
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-gantt FILE | -csv] [-quiet] [-scan] [-cpus N] [-cfs-gran Q] [-runs N] [-threads N] [-seed S] [-jobs N] [-trace FILE]\n"
+                    "          [-quantum R] [-aging R] [-max-idle R] [-min-jobs R] [-switch-at T] [-live MS] [-ci W]\n"
+                    "       %s -import JOBS.csv TRACE.bin\n"
+                    "R is a value or a range LO:HI[:STEP]; ranges sweep every combination.\n", prog, prog);
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    const char *gantt_path = NULL;
+    bool quiet = false;
+    bool scan = false;
+    int num_cpus = 1;
+    int min_granularity = 0;
+    int num_runs = NUM_RUNS;
+    bool runs_set = false;
+    double ci_width = 0;    // -ci: target 95% half-width, 0 = fixed run count
+    int num_threads = cpu_count();
     int base_seed = time(NULL);
-    printf("BASE SEED: %d\n\n", base_seed);
+    int job_count = 0;
+    const char *trace_path = NULL;
+    int switch_at = -1;
+    int live_ms = 0;
+    Range ranges[NUM_KNOBS] = {
+        [KNOB_QUANTUM] = { DEFAULT_QUANTUM, DEFAULT_QUANTUM, 1 },
+        [KNOB_AGING] = { DEFAULT_AGING_LIMIT, DEFAULT_AGING_LIMIT, 1 },
+        [KNOB_IDLE] = { MAX_IDLE_ALLOWANCE, MAX_IDLE_ALLOWANCE, 1 },
+        [KNOB_MIN_JOBS] = { INITIAL_JOB_COUNT, INITIAL_JOB_COUNT, 1 },
+    };
 
-    for (int run = 0; run < NUM_RUNS; run++) {
-        Process workload[MAX_JOBS];
-        int count = generate_workload(workload, base_seed + run);
-        for (int i = 0; i < 6; i++) {
-            run_simulation_step(names[i], run, funcs[i], workload, count, &stats[i], enable_csv);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-csv") == 0) {
+            gantt_path = "gantt.csv";
+        } else if (strcmp(argv[i], "-gantt") == 0 && i + 1 < argc) {
+            gantt_path = argv[++i];
+        } else if (strcmp(argv[i], "-quiet") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "-scan") == 0) {
+            scan = true;
+        } else if (strcmp(argv[i], "-cpus") == 0 && i + 1 < argc) {
+            num_cpus = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-cfs-gran") == 0 && i + 1 < argc) {
+            min_granularity = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-runs") == 0 && i + 1 < argc) {
+            num_runs = atoi(argv[++i]);
+            runs_set = true;
+        } else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc) {
+            base_seed = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-jobs") == 0 && i + 1 < argc) {
+            job_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "-quantum") == 0 && i + 1 < argc) {
+            if (!parse_range(argv[++i], &ranges[KNOB_QUANTUM])) usage(argv[0]);
+        } else if (strcmp(argv[i], "-aging") == 0 && i + 1 < argc) {
+            if (!parse_range(argv[++i], &ranges[KNOB_AGING])) usage(argv[0]);
+        } else if (strcmp(argv[i], "-max-idle") == 0 && i + 1 < argc) {
+            if (!parse_range(argv[++i], &ranges[KNOB_IDLE])) usage(argv[0]);
+        } else if (strcmp(argv[i], "-min-jobs") == 0 && i + 1 < argc) {
+            if (!parse_range(argv[++i], &ranges[KNOB_MIN_JOBS])) usage(argv[0]);
+        } else if (strcmp(argv[i], "-switch-at") == 0 && i + 1 < argc) {
+            switch_at = atoi(argv[++i]);
+            if (switch_at < 0) usage(argv[0]);
+        } else if (strcmp(argv[i], "-ci") == 0 && i + 1 < argc) {
+            ci_width = atof(argv[++i]);
+            if (!(ci_width > 0)) usage(argv[0]);
+        } else if (strcmp(argv[i], "-live") == 0 && i + 1 < argc) {
+            live_ms = atoi(argv[++i]);
+            if (live_ms < 1) usage(argv[0]);
+        } else if (strcmp(argv[i], "-import") == 0 && i + 2 < argc) {
+            return trace_import_csv(argv[i + 1], argv[i + 2]) ? 0 : 1;
+        } else {
+            usage(argv[0]);
         }
     }
+    if (num_runs < 1 || num_threads < 1 || job_count < 0 || num_cpus < 1 || min_granularity < 0) usage(argv[0]);
+    if (ranges[KNOB_QUANTUM].lo < 1 || ranges[KNOB_AGING].lo < 1 || ranges[KNOB_IDLE].lo < 0 || ranges[KNOB_MIN_JOBS].lo < 0) usage(argv[0]);
 
-    printf("\n[==========] Final Statistics (Average over 5 runs) [==========]\n");
-    printf("%-10s %-12s %-12s %-12s %-12s\n", "Algorithm", "Avg TAT", "Avg Wait", "Avg Resp", "Throughput");
-    printf("------------------------------------------------------------\n");
-
-    for (int i = 0; i < 6; i++) {
-        if (stats[i].valid_runs > 0) {
-            double div = stats[i].valid_runs;
-            printf("%-10s %-12.2f %-12.2f %-12.2f %-12.2f\n", 
-                names[i],
-                stats[i].total_turnaround / div,
-                stats[i].total_waiting / div,
-                stats[i].total_response / div,
-                (stats[i].total_throughput / div) * 100.0
-            );
+    int num_points;
+    Knobs *points = build_points(ranges, &num_points);
+    bool sweep = num_points > 1;
+    if (sweep && gantt_path) {
+        fprintf(stderr, "-gantt cannot be combined with a sweep\n");
+        return 1;
+    }
+    bool whatif = switch_at >= 0;
+    if (whatif && (sweep || gantt_path)) {
+        fprintf(stderr, "-switch-at cannot be combined with a sweep or -gantt\n");
+        return 1;
+    }
+    bool ci = ci_width > 0;
+    if (ci && (sweep || whatif || trace_path || live_ms > 0)) {
+        fprintf(stderr, "-ci cannot be combined with a sweep, -switch-at, -trace or -live\n");
+        return 1;
+    }
+    if (ci && !runs_set) num_runs = CI_MAX_RUNS; // -runs is the cap
+    if (live_ms > 0 && (sweep || gantt_path || whatif || num_cpus > 1)) {
+        fprintf(stderr, "-live replays one CPU and cannot be combined with a sweep, -gantt, -switch-at or -cpus\n");
+        return 1;
+    }
+
+    // Replaying a trace: every run would be identical, so do one
+    Trace trace;
+    Workload trace_workload = {0};
+    if (trace_path) {
+        if (!trace_open(&trace, trace_path)) return 1;
+        trace_workload.source = &trace.source;
+        trace_workload.count = trace.count;
+        trace_workload.horizon = trace.count > 0 ? trace.rec[trace.count - 1].arrival + 1 : 0;
+        trace_workload.cutoff = INT_MAX; // a real trace never drops jobs
+        trace_workload.seed = (uint64_t)base_seed;
+        num_runs = 1;
+    }
+
+    if (live_ms > 0) {
+        RunOptions opt = { .cpus = 1, .scan = scan, .min_granularity = min_granularity };
+        Workload live_workload = {0};
+        if (!trace_path) generate_workload(&live_workload, base_seed, job_count, 1, &points[0]);
+        int status = run_live(trace_path ? &trace_workload : &live_workload, &opt, &points[0], live_ms);
+        free_workload(&live_workload);
+        free(points);
+        return status;
+    }
+
+    // Every run's segments go to one file, written by this thread in run order
+    GanttWriter gantt;
+    if (gantt_path && !gantt_open(&gantt, gantt_path, names, NUM_ALGOS)) return 1;
+
+    // [point][algo], what-if: [before][after]
+    int num_stats = whatif ? NUM_ALGOS * NUM_ALGOS : num_points * NUM_ALGOS;
+    SimulationStats *stats = xcalloc(num_stats, sizeof(SimulationStats));
+    if (num_cpus > 1) {
+        for (int a = 0; a < num_stats; a++) {
+            stats[a].cpu_util = xcalloc(num_cpus, sizeof(double));
+            stats[a].cpu_migrations = xcalloc(num_cpus, sizeof(double));
+        }
+    }
+    if (trace_path) printf("TRACE: %s (%d jobs)\n", trace_path, trace.count);
+    else printf("BASE SEED: %d\n", base_seed);
+    if (num_cpus > 1) printf("CPUS: %d\n", num_cpus);
+    printf("\n");
+
+    // A sweep or a what-if run only reports its table
+    ThreadPool *pool = pool_create(num_threads);
+    BatchCtx ctx = { .base_seed = base_seed, .job_count = job_count, .points = points, .num_runs = num_runs,
+                     .switch_at = switch_at,
+                     .opt = { .report = !quiet && !sweep && !whatif, .keep_log = gantt_path != NULL, .scan = scan,
+                              .cpus = num_cpus, .min_granularity = min_granularity } };
+    if (trace_path) ctx.trace = &trace_workload;
+    int num_units = num_points * num_runs;
+    int batch_cap = num_units < BATCH_RUNS ? num_units : BATCH_RUNS;
+    int per_task = whatif ? NUM_ALGOS : 1; // results per task
+    ctx.results = xcalloc((size_t)batch_cap * NUM_ALGOS * per_task, sizeof(RunResult));
+    ctx.cache = xcalloc(pool_size(pool), sizeof(WorkerCache));
+    for (int w = 0; w < pool_size(pool); w++) ctx.cache[w].unit = -1;
+    if (quiet && !sweep && !whatif) ctx.tails = xcalloc((size_t)pool_size(pool) * NUM_ALGOS, sizeof(TailStats));
+
+    CiState *ci_state = NULL;
+    int *task_map = NULL;
+    if (ci) {
+        ci_state = xcalloc(NUM_ALGOS, sizeof(CiState));
+        ctx.task_map = task_map = xmalloc(sizeof(int) * batch_cap * NUM_ALGOS);
+    }
+
+    for (int first = 0;;) {
+        int ntasks;
+        if (ci) {
+            ntasks = plan_ci_batch(ci_state, task_map, num_runs, ci_width);
         } else {
-             printf("%-10s [ NO DATA ]\n", names[i]);
+            int batch = num_units - first < BATCH_RUNS ? num_units - first : BATCH_RUNS;
+            ctx.first_unit = first;
+            ntasks = batch * NUM_ALGOS;
+            first += batch;
+        }
+        if (ntasks <= 0) break;
+        pool_run(pool, ntasks, whatif ? whatif_task : run_task, &ctx);
+
+        // In-order reduction
+        for (int r = 0; r < ntasks * per_task; r++) {
+            RunResult *res = &ctx.results[r];
+            int t = r / per_task;
+            int unit = task_id(&ctx, t) / NUM_ALGOS;
+            int algo = task_id(&ctx, t) % NUM_ALGOS;
+            if (res->report) {
+                fwrite(res->report, 1, res->report_len, stdout);
+                free(res->report);
+                res->report = NULL;
+            }
+            int slot = whatif ? r % (NUM_ALGOS * NUM_ALGOS) : unit / num_runs * NUM_ALGOS + algo;
+            accumulate(&stats[slot], res, num_cpus);
+            if (ci) ci_add(&ci_state[algo], res);
+            free(res->cpu);
+            if (gantt_path) {
+                gantt_add(&gantt, unit + 1, algo, &res->log);
+                seglog_free(&res->log);
+            }
+        }
+        if (gantt_path) gantt_flush(&gantt);
+    }
+    free(task_map);
+    if (gantt_path && !gantt_close(&gantt)) return 1;
+    for (int w = 0; w < pool_size(pool); w++) {
+        free_workload(&ctx.cache[w].workload);
+        arena_free(&ctx.cache[w].arena);
+    }
+    // Histograms only add, so folding workers in any order is exact
+    TailStats *tails = NULL;
+    if (ctx.tails) {
+        tails = ctx.tails;
+        for (int w = 1; w < pool_size(pool); w++) {
+            for (int a = 0; a < NUM_ALGOS; a++) {
+                for (int m = 0; m < NUM_METRICS; m++) {
+                    for (int c = 0; c < NUM_CLASSES; c++) {
+                        hist_merge(&tails[a].h[m][c], &ctx.tails[w * NUM_ALGOS + a].h[m][c]);
+                    }
+                }
+            }
         }
     }
+    pool_destroy(pool);
+    free(ctx.results);
+    free(ctx.cache);
+    if (trace_path) trace_close(&trace);
+
+    if (sweep) {
+        print_sweep(stats, points, num_points, num_runs);
+    } else if (whatif) {
+        print_whatif(stats, switch_at, num_runs);
+    } else if (ci) {
+        print_ci_table(stats, ci_state, ci_width, num_runs);
+        if (num_cpus > 1) print_cpu_table(stats, num_cpus);
+    } else {
+        printf("\n[==========] Final Statistics (Average over %d runs) [==========]\n", num_runs);
+        printf("%-10s %-12s %-12s %-12s %-12s", "Algorithm", "Avg TAT", "Avg Wait", "Avg Resp", "Throughput");
+        if (num_cpus > 1) printf(" %-12s %-12s", "Util %", "Migr/run");
+        printf("\n------------------------------------------------------------%s\n", num_cpus > 1 ? "--------------------------" : "");
+
+        for (int i = 0; i < NUM_ALGOS; i++) {
+            if (stats[i].valid_runs > 0) {
+                double div = stats[i].valid_runs;
+                printf("%-10s %-12.2f %-12.2f %-12.2f %-12.2f", 
+                    names[i],
+                    stats[i].total_turnaround / div,
+                    stats[i].total_waiting / div,
+                    stats[i].total_response / div,
+                    (stats[i].total_throughput / div) * 100.0
+                );
+                if (num_cpus > 1) {
+                    double util = 0, migr = 0;
+                    for (int c = 0; c < num_cpus; c++) {
+                        util += stats[i].cpu_util[c];
+                        migr += stats[i].cpu_migrations[c];
+                    }
+                    printf(" %-12.2f %-12.2f", 100.0 * util / num_cpus / div, migr / div);
+                }
+                printf("\n");
+            } else {
+                 printf("%-10s [ NO DATA ]\n", names[i]);
+            }
+        }
+
+        if (num_cpus > 1) print_cpu_table(stats, num_cpus);
+    }
+    for (int a = 0; a < num_stats; a++) {
+        free(stats[a].cpu_util);
+        free(stats[a].cpu_migrations);
+    }
+    free(stats);
+    free(points);
+    free(ci_state);
+
+    if (tails) {
+        printf("\n[==========] Per-Job Latency Percentiles (quanta, all runs) [==========]\n");
+        print_tails("Turnaround", tails, METRIC_TAT);
+        print_tails("Waiting", tails, METRIC_WAIT);
+        print_tails("Response", tails, METRIC_RESP);
+        free(tails);
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -1,54 +1,97 @@
-import pandas as pd
-import matplotlib.pyplot as plt
-import glob
+import array
+import csv
 import os
+import struct
+import sys
 
-def generate_gantt_chart(csv_file, output_file):
-    try:
-        df = pd.read_csv(csv_file)
-        if df.empty: return
+# Reads the single Gantt file written by './scheduler -gantt FILE' (or -csv,
+# which writes gantt.csv) and draws one chart per algorithm for one run.
+# Rows are streamed, so only the chosen run's segments are ever held.
+#
+#   python3 plot_gantt.py [FILE] [RUN]      (defaults: gantt.csv, run 3)
 
-        df['Duration'] = df['End'] - df['Start']
+GANTT_MAGIC = b"SCHGNT01"
+COLUMNS = ("run", "algo", "job", "cpu", "start", "end")
 
-        fig, ax = plt.subplots(figsize=(12, 6)) # Slightly smaller size for reports
-        
-        # Color mapping
-        unique_jobs = sorted(df['Job'].unique())
-        cmap = plt.get_cmap('tab20')
-        job_colors = {job: cmap(i % 20) for i, job in enumerate(unique_jobs)}
+def read_csv(path):
+    with open(path, newline="") as f:
+        for row in csv.DictReader(f):
+            yield (int(row["run"]), row["algo"], int(row["job"]), int(row["cpu"]),
+                   int(row["start"]), int(row["end"]))
 
-        for i, row in df.iterrows():
-            ax.barh(y=row['Job'], width=row['Duration'], left=row['Start'], 
-                    color=job_colors[row['Job']], edgecolor='black', height=0.6)
+def read_binary(path):
+    with open(path, "rb") as f:
+        magic, num_algos, name_len = struct.unpack("=8sII", f.read(16))
+        if magic != GANTT_MAGIC:
+            raise ValueError(f"{path}: not a Gantt file")
+        names = [f.read(name_len).split(b"\0", 1)[0].decode() for _ in range(num_algos)]
 
-        # Clean Title (e.g., "FCFS - Run 3")
-        clean_name = os.path.basename(csv_file).replace('gantt_', '').replace('.csv', '').replace('_', ' ')
-        ax.set_title(f'Gantt Chart: {clean_name}')
-        ax.set_xlabel('Time Quanta')
-        ax.set_ylabel('Job ID')
-        ax.grid(True, axis='x', linestyle='--', alpha=0.5)
-        ax.set_xlim(0, max(100, df['End'].max()))
+        # One columnar block per batch of runs
+        while True:
+            head = f.read(8)
+            if len(head) < 8:
+                return
+            rows, ncols = struct.unpack("=II", head)
+            cols = []
+            for _ in range(ncols):
+                col = array.array("i")
+                col.fromfile(f, rows)
+                cols.append(col)
+            run, algo, job, cpu, start, end = cols[:len(COLUMNS)]
+            for r in range(rows):
+                yield run[r], names[algo[r]], job[r], cpu[r], start[r], end[r]
 
-        plt.tight_layout()
-        plt.savefig(output_file)
-        plt.close()
-        print(f"Generated: {output_file}")
+def read_segments(path):
+    return read_csv(path) if path.endswith(".csv") else read_binary(path)
 
-    except Exception as e:
-        print(f"Skipped {csv_file}: {e}")
+def generate_gantt_chart(algo, run, segs, output_file):
+    import matplotlib
+    matplotlib.use("Agg")
+    import matplotlib.pyplot as plt
+
+    cpus = max(cpu for _, cpu, _, _ in segs) + 1
+    fig, axes = plt.subplots(cpus, 1, figsize=(12, 6 if cpus == 1 else 3 * cpus), squeeze=False)
+
+    # Color mapping
+    cmap = plt.get_cmap("tab20")
+    job_colors = {job: cmap(i % 20) for i, job in enumerate(sorted({s[0] for s in segs}))}
+    end_max = max(100, max(s[3] for s in segs))
+
+    for c in range(cpus):
+        ax = axes[c][0]
+        for job, cpu, start, end in segs:
+            if cpu != c:
+                continue
+            ax.barh(y=job, width=end - start, left=start, color=job_colors[job], edgecolor="black", height=0.6)
+        ax.set_ylabel("Job ID" if cpus == 1 else f"CPU{c} Job ID")
+        ax.grid(True, axis="x", linestyle="--", alpha=0.5)
+        ax.set_xlim(0, end_max)
+
+    axes[0][0].set_title(f"Gantt Chart: {algo} Run {run}")
+    axes[-1][0].set_xlabel("Time Quanta")
+    plt.tight_layout()
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Generated: {output_file}")
 
 def main():
-    # FILTER: Only look for Run 3 files
-    csv_files = glob.glob("*_run3.csv")
-    
-    if not csv_files:
-        print("No CSVs found for Run 3. Make sure the C code generated them!")
+    path = sys.argv[1] if len(sys.argv) > 1 else "gantt.csv"
+    run = int(sys.argv[2]) if len(sys.argv) > 2 else 3
+    if not os.path.exists(path):
+        print(f"{path} not found. Run './scheduler -gantt {path}' first!")
+        return
+
+    by_algo = {}
+    for r, algo, job, cpu, start, end in read_segments(path):
+        if r == run:
+            by_algo.setdefault(algo, []).append((job, cpu, start, end))
+    if not by_algo:
+        print(f"No segments for run {run} in {path}")
         return
 
-    print(f"Found {len(csv_files)} files for Run 3...")
-    for csv_file in csv_files:
-        output_file = csv_file.replace(".csv", ".png")
-        generate_gantt_chart(csv_file, output_file)
+    print(f"Found {len(by_algo)} algorithms for Run {run}...")
+    for algo, segs in by_algo.items():
+        generate_gantt_chart(algo, run, segs, f"gantt_{algo}_run{run}.png")
 
 if __name__ == "__main__":
-    main()
\ No newline at end of file
+    main()
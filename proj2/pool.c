@@ -0,0 +1,117 @@
+#include <pthread.h>
+#include <unistd.h>
+#include "scheduler.h"
+#include "pool.h"
+
+typedef struct {
+    ThreadPool *pool;
+    int id;
+} WorkerArg;
+
+struct ThreadPool {
+    pthread_t *threads;
+    WorkerArg *args;
+    int nthreads;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_cv;     // new batch or shutdown
+    pthread_cond_t done_cv;     // batch finished
+
+    TaskFunc fn;
+    void *ctx;
+    int ntasks;
+    int next;       // next task to hand out
+    int pending;    // tasks not finished yet
+    bool shutdown;
+};
+
+static void *worker_main(void *arg) {
+    WorkerArg *wa = arg;
+    ThreadPool *pool = wa->pool;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->shutdown && pool->next >= pool->ntasks)
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        if (pool->shutdown) break;
+
+        int task = pool->next++;
+        TaskFunc fn = pool->fn;
+        void *ctx = pool->ctx;
+        pthread_mutex_unlock(&pool->lock);
+
+        fn(ctx, task, wa->id);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) pthread_cond_signal(&pool->done_cv);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ThreadPool *pool_create(int nthreads) {
+    ThreadPool *pool = xcalloc(1, sizeof(ThreadPool));
+    pool->nthreads = nthreads < 1 ? 1 : nthreads;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+
+    // A single worker runs batches inline on the caller's thread
+    if (pool->nthreads == 1) return pool;
+
+    pool->threads = xmalloc(sizeof(pthread_t) * pool->nthreads);
+    pool->args = xmalloc(sizeof(WorkerArg) * pool->nthreads);
+    for (int i = 0; i < pool->nthreads; i++) {
+        pool->args[i] = (WorkerArg){ pool, i };
+        if (pthread_create(&pool->threads[i], NULL, worker_main, &pool->args[i]) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(1);
+        }
+    }
+    return pool;
+}
+
+void pool_run(ThreadPool *pool, int ntasks, TaskFunc fn, void *ctx) {
+    if (ntasks <= 0) return;
+    if (!pool->threads) {
+        for (int t = 0; t < ntasks; t++) fn(ctx, t, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->ntasks = ntasks;
+    pool->next = 0;
+    pool->pending = ntasks;
+    pthread_cond_broadcast(&pool->work_cv);
+    while (pool->pending > 0) pthread_cond_wait(&pool->done_cv, &pool->lock);
+    pool->ntasks = 0;
+    pool->next = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+int pool_size(const ThreadPool *pool) {
+    return pool->nthreads;
+}
+
+void pool_destroy(ThreadPool *pool) {
+    if (pool->threads) {
+        pthread_mutex_lock(&pool->lock);
+        pool->shutdown = true;
+        pthread_cond_broadcast(&pool->work_cv);
+        pthread_mutex_unlock(&pool->lock);
+        for (int i = 0; i < pool->nthreads; i++) pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_cv);
+    pthread_cond_destroy(&pool->done_cv);
+    free(pool->threads);
+    free(pool->args);
+    free(pool);
+}
+
+int cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
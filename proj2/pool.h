@@ -0,0 +1,21 @@
+#ifndef POOL_H
+#define POOL_H
+
+// --- Thread Pool ---
+// Fixed set of worker threads that drain a batch of numbered tasks.
+// pool_run blocks until every task in the batch has finished; tasks are
+// handed out in index order but may complete in any order.
+
+typedef void (*TaskFunc)(void *ctx, int task, int worker);
+
+typedef struct ThreadPool ThreadPool;
+
+ThreadPool *pool_create(int nthreads);
+void pool_run(ThreadPool *pool, int ntasks, TaskFunc fn, void *ctx);
+int pool_size(const ThreadPool *pool);
+void pool_destroy(ThreadPool *pool);
+
+// Online CPUs, at least 1
+int cpu_count(void);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// --- Per-Task Random Streams ---
+// SplitMix64: one 64-bit word of state, so every task can own a generator
+// instead of sharing the global rand(). A (seed, stream) pair always gives
+// the same sequence no matter which thread draws from it.
+
+typedef struct {
+    uint64_t state;
+} Rng;
+
+static inline uint64_t rng_mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline void rng_seed(Rng *r, uint64_t seed, uint64_t stream) {
+    r->state = rng_mix(seed) ^ rng_mix(stream + 0x9E3779B97F4A7C15ULL);
+}
+
+static inline uint64_t rng_next(Rng *r) {
+    r->state += 0x9E3779B97F4A7C15ULL;
+    return rng_mix(r->state);
+}
+
+// Uniform integer in [0, n)
+static inline int rng_range(Rng *r, int n) {
+    return (int)(((rng_next(r) >> 32) * (uint64_t)n) >> 32);
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include "runqueue.h"
+
+void rq_init(RunQueue *q, int cap_hint) {
+    unsigned cap = 16;
+    while ((int)cap < cap_hint) cap <<= 1;
+    q->slot = xmalloc(sizeof(int) * cap);
+    q->mask = cap - 1;
+    q->head = q->tail = 0;
+    q->live = 0;
+}
+
+void rq_free(RunQueue *q) {
+    free(q->slot);
+    q->slot = NULL;
+    q->live = 0;
+}
+
+void rq_copy(RunQueue *dst, const RunQueue *src) {
+    *dst = *src;
+    dst->slot = xmemdup(src->slot, sizeof(int) * (src->mask + 1));
+}
+
+// Doubles the ring; entries keep their absolute positions so handles survive
+static void rq_grow(RunQueue *q) {
+    unsigned old_mask = q->mask;
+    unsigned new_mask = (old_mask + 1) * 2 - 1;
+    int *slot = xmalloc(sizeof(int) * (new_mask + 1));
+    for (unsigned pos = q->head; pos != q->tail; pos++) {
+        slot[pos & new_mask] = q->slot[pos & old_mask];
+    }
+    free(q->slot);
+    q->slot = slot;
+    q->mask = new_mask;
+}
+
+unsigned rq_push(RunQueue *q, int job) {
+    if (q->tail - q->head > q->mask) rq_grow(q);
+    unsigned handle = q->tail++;
+    q->slot[handle & q->mask] = job;
+    q->live++;
+    return handle;
+}
+
+int rq_pop(RunQueue *q) {
+    if (q->head == q->tail) return -1;
+    int job = q->slot[q->head++ & q->mask];
+    q->live--;
+    // Keep the head on a live entry so rq_peek can read it directly
+    while (q->head != q->tail && q->slot[q->head & q->mask] == RQ_HOLE) q->head++;
+    return job;
+}
+
+void rq_remove(RunQueue *q, unsigned handle) {
+    q->slot[handle & q->mask] = RQ_HOLE;
+    q->live--;
+    // Trim holes at the ends so they don't linger until the next pop
+    while (q->head != q->tail && q->slot[q->head & q->mask] == RQ_HOLE) q->head++;
+    while (q->head != q->tail && q->slot[(q->tail - 1) & q->mask] == RQ_HOLE) q->tail--;
+}
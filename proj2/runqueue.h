@@ -0,0 +1,37 @@
+#ifndef RUNQUEUE_H
+#define RUNQUEUE_H
+
+#include "scheduler.h"
+
+// --- Circular FIFO Run Queue ---
+// Growable ring buffer of job indices with O(1) push/pop. Every push returns
+// a handle (the entry's absolute position) that stays valid across growth, so
+// a job can be pulled out of the middle in O(1): its slot becomes a hole that
+// pop skips later.
+
+#define RQ_HOLE (-1)
+
+typedef struct {
+    int *slot;
+    unsigned mask;          // capacity - 1, capacity is a power of two
+    unsigned head, tail;    // absolute positions, entries live in [head, tail)
+    int live;               // entries that are not holes
+} RunQueue;
+
+void rq_init(RunQueue *q, int cap_hint);
+void rq_free(RunQueue *q);
+void rq_copy(RunQueue *dst, const RunQueue *src);   // handles stay valid in the copy
+
+unsigned rq_push(RunQueue *q, int job);
+int rq_pop(RunQueue *q);                    // -1 when empty
+void rq_remove(RunQueue *q, unsigned handle);
+
+static inline bool rq_empty(const RunQueue *q) { return q->live == 0; }
+
+// Oldest entry without removing it, -1 when empty (the head is never a hole)
+static inline int rq_peek(const RunQueue *q) { return q->live ? q->slot[q->head & q->mask] : -1; }
+
+// Entry at absolute position 'pos' in [head, tail); RQ_HOLE if removed
+static inline int rq_at(const RunQueue *q, unsigned pos) { return q->slot[pos & q->mask]; }
+
+#endif
@@ -4,9 +4,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-#define MAX_JOBS 100
-#define TOTAL_QUANTA 100
+#define TOTAL_QUANTA 100 // default start cutoff / arrival window
+#define DEFAULT_QUANTUM 1       // RR time slice
+#define DEFAULT_AGING_LIMIT 5   // HPF: quanta waited at one level before moving up
 
 // --- Formatting Macros ---
 #define COLOR_RED     "\033[31m"
@@ -14,27 +16,74 @@
 #define COLOR_YELLOW  "\033[33m"
 #define COLOR_RESET   "\033[0m"
 
+// What a job is: written once when the workload is built, then shared
+// read-only by every run, algorithm and thread
 typedef struct {
-    int id;             
-    char name;          
-    int arrival_time;   
-    int run_time;       
-    int priority;       
-    
-    // Dynamic State
-    int remaining_time; 
-    int start_time;     
-    int finish_time;    
-    
-    // NEW: The process tracks its own execution history
-    // This removes the need for 'time_chart' in the algo arguments
-    bool history[TOTAL_QUANTA];
-
-    // Stats
-    int waiting_time;
-    int turnaround_time;
-    int response_time;
-} Process;
+    int id;
+    char name;
+    int arrival_time;
+    int run_time;
+    int priority;       // initial priority, 1-4
+} JobSpec;
+
+// What a run changes about a job. Kept apart from the spec so that starting
+// a run rewrites these few fields instead of copying whole jobs.
+typedef struct {
+    int remaining_time;
+    int start_time;     // -1 until first dispatched
+    int finish_time;    // 0 until done
+    int priority;       // current priority (HPF aging raises it)
+} JobState;
+
+// Fresh run state for spec[0..count)
+void jobstate_init(JobState *st, const JobSpec *spec, int count);
+
+// Jobs streamed in arrival order from outside a JobSpec array (e.g. a
+// mapped trace file). 'load' fills the spec of job 'index'.
+typedef struct JobSource {
+    int count;
+    int (*arrival)(const struct JobSource *src, int index);
+    void (*load)(const struct JobSource *src, int index, JobSpec *dst);
+    void *ctx;
+} JobSource;
+
+// A generated or loaded job set, sorted by arrival. Either 'jobs' holds every
+// job, or it is NULL and 'source' streams them.
+typedef struct {
+    JobSpec *jobs;
+    const JobSource *source;
+    int count;
+    int horizon;    // arrival window, the minimum span reported for a run
+    int cutoff;     // jobs not started by then are dropped
+    uint64_t seed;  // also seeds the randomized policies run on it
+} Workload;
+
+// Work done by the engine in one run
+typedef struct {
+    long events;        // events popped from the event heap
+    long decisions;     // times a job was picked for the CPU
+} EngineStats;
+
+// What one simulated CPU did in a run
+typedef struct {
+    long busy;          // quanta spent running jobs
+    long migrations;    // jobs it stole from another CPU's ready queue
+} CpuStats;
+
+// Knobs shared by every algorithm in a run
+typedef struct {
+    int cutoff;     // a job that has not started by this quantum is dropped
+    const JobSource *source; // if set, jobs are loaded as they arrive...
+    JobSpec *stream_specs;   // ...into these [count] slots
+    EngineStats *stats;      // optional, filled in by the engine
+    bool scan;               // SJF/SRT/HPF-NP select by SoA min-scan instead of a heap
+    int cpus;                // simulated CPUs, 0 or 1 = the classic single CPU
+    CpuStats *cpu_stats;     // optional, [cpus] filled in by the engine
+    int min_granularity;     // CFS shortest slice in quanta, 0 = default
+    int quantum;             // RR time slice, 0 = DEFAULT_QUANTUM
+    int aging_limit;         // HPF aging threshold, 0 = DEFAULT_AGING_LIMIT
+    uint64_t seed;           // Lottery draws; the same seed gives the same schedule
+} SimParams;
 
 typedef struct {
     double total_turnaround;
@@ -42,17 +91,45 @@ typedef struct {
     double total_response;
     double total_throughput;
     int valid_runs;
+    double *cpu_util;        // [cpus] per-run utilization sums, multi-CPU only
+    double *cpu_migrations;  // [cpus] per-run migration sums, multi-CPU only
 } SimulationStats;
 
-// CLEANER SIGNATURE: No more 'char* time_chart'
-typedef void (*AlgoFunc)(Process* p, int count);
+// Execution history as a run-length log: one entry per stretch a job held
+// the CPU, so its size tracks context switches rather than the horizon.
+typedef struct {
+    int job;    // index into the run's job arrays
+    int cpu;
+    int start;
+    int end;    // exclusive
+} Segment;
+
+typedef struct {
+    Segment *seg;
+    int count, cap;
+} SegmentLog;
+
+void seglog_append(SegmentLog *log, int job, int cpu, int start, int end);
+void seglog_free(SegmentLog *log);
+
+// CLEANER SIGNATURE: No more 'char* time_chart', the algorithm appends to 'log'.
+// 'spec' is only read (NULL when params->source streams the jobs); 'st' is the run.
+typedef void (*AlgoFunc)(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
+
+// --- Allocation Helpers (exit on failure) ---
+void *xmalloc(size_t size);
+void *xcalloc(size_t n, size_t size);
+void *xmemdup(const void *src, size_t size);
 
 // --- Algorithm Prototypes ---
-void run_FCFS(Process *p, int count);
-void run_SJF(Process *p, int count);
-void run_SRT(Process *p, int count);
-void run_RR(Process *p, int count);
-void run_HPF_NonPreemptive(Process *p, int count);
-void run_HPF_Preemptive(Process *p, int count);
+void run_FCFS(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
+void run_SJF(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
+void run_SRT(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
+void run_RR(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
+void run_HPF_NonPreemptive(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
+void run_HPF_Preemptive(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
+void run_CFS(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
+void run_Lottery(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
+void run_Stride(const JobSpec *spec, JobState *st, int count, const SimParams *params, SegmentLog *log);
 
 #endif
\ No newline at end of file
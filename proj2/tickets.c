@@ -0,0 +1,95 @@
+#include <string.h>
+#include "tickets.h"
+
+void tpool_init(TicketPool *t, int cap_hint) {
+    int cap = 16;
+    while (cap < cap_hint) cap <<= 1;
+    t->tree = xcalloc(cap + 1, sizeof(int64_t));
+    t->tickets = xcalloc(cap, sizeof(int));
+    t->job = xmalloc(sizeof(int) * cap);
+    t->free_slot = xmalloc(sizeof(int) * cap);
+    t->nfree = t->used = t->size = 0;
+    t->cap = cap;
+    t->total = 0;
+}
+
+void tpool_free(TicketPool *t) {
+    free(t->tree);
+    free(t->tickets);
+    free(t->job);
+    free(t->free_slot);
+    t->tree = NULL;
+    t->size = 0;
+}
+
+void tpool_copy(TicketPool *dst, const TicketPool *src) {
+    *dst = *src;
+    dst->tree = xmemdup(src->tree, sizeof(int64_t) * (src->cap + 1));
+    dst->tickets = xmemdup(src->tickets, sizeof(int) * src->cap);
+    dst->job = xmemdup(src->job, sizeof(int) * src->cap);
+    dst->free_slot = xmemdup(src->free_slot, sizeof(int) * src->cap);
+}
+
+static void fenwick_add(TicketPool *t, int slot, int64_t delta) {
+    for (int i = slot + 1; i <= t->cap; i += i & -i) t->tree[i] += delta;
+}
+
+// Doubles the slot arrays and rebuilds the tree bottom-up in O(cap)
+static void tpool_grow(TicketPool *t) {
+    int cap = t->cap * 2;
+    int *tickets = xcalloc(cap, sizeof(int));
+    int *job = xmalloc(sizeof(int) * cap);
+    int *free_slot = xmalloc(sizeof(int) * cap);
+    memcpy(tickets, t->tickets, sizeof(int) * t->cap);
+    memcpy(job, t->job, sizeof(int) * t->cap);
+    memcpy(free_slot, t->free_slot, sizeof(int) * t->nfree);
+    free(t->tickets);
+    free(t->job);
+    free(t->free_slot);
+    free(t->tree);
+    t->tickets = tickets;
+    t->job = job;
+    t->free_slot = free_slot;
+    t->cap = cap;
+
+    t->tree = xcalloc(cap + 1, sizeof(int64_t));
+    for (int i = 1; i <= cap; i++) {
+        t->tree[i] += t->tickets[i - 1];
+        int up = i + (i & -i);
+        if (up <= cap) t->tree[up] += t->tree[i];
+    }
+}
+
+void tpool_add(TicketPool *t, int job, int tickets) {
+    int slot;
+    if (t->nfree > 0) slot = t->free_slot[--t->nfree];
+    else {
+        if (t->used == t->cap) tpool_grow(t);
+        slot = t->used++;
+    }
+    t->job[slot] = job;
+    t->tickets[slot] = tickets;
+    fenwick_add(t, slot, tickets);
+    t->size++;
+    t->total += tickets;
+}
+
+int tpool_take(TicketPool *t, int64_t ticket) {
+    // Binary descent: 'pos' ends as the longest prefix of slots holding no
+    // more than 'ticket' tickets, so the winner is the 0-based slot 'pos'
+    int pos = 0;
+    for (int step = t->cap >> 1; step > 0; step >>= 1) {
+        if (t->tree[pos + step] <= ticket) {
+            pos += step;
+            ticket -= t->tree[pos];
+        }
+    }
+    int slot = pos;
+    int job = t->job[slot];
+    fenwick_add(t, slot, -t->tickets[slot]);
+    t->total -= t->tickets[slot];
+    t->tickets[slot] = 0;
+    t->free_slot[t->nfree++] = slot;
+    t->size--;
+    return job;
+}
@@ -0,0 +1,37 @@
+#ifndef TICKETS_H
+#define TICKETS_H
+
+#include <stdint.h>
+#include "scheduler.h"
+
+// --- Lottery Ticket Pool ---
+// Ready jobs each hold a slot with some tickets. A Fenwick (binary indexed)
+// tree over the slots' ticket counts finds the slot holding ticket number r
+// in O(log n), so a draw costs the same with ten jobs or 10^5. Freed slots
+// are reused, so the pool only grows to the most jobs ever ready at once.
+
+typedef struct {
+    int64_t *tree;      // Fenwick tree over 'tickets', 1-based
+    int *tickets;       // per slot, 0 when free
+    int *job;           // per slot
+    int *free_slot;     // stack of free slots
+    int nfree;
+    int cap;            // slots, a power of two
+    int used;           // slots ever handed out
+    int size;           // jobs in the pool
+    int64_t total;      // tickets in the pool
+} TicketPool;
+
+void tpool_init(TicketPool *t, int cap_hint);
+void tpool_free(TicketPool *t);
+void tpool_copy(TicketPool *dst, const TicketPool *src);
+
+// Adds 'job' holding 'tickets' (> 0)
+void tpool_add(TicketPool *t, int job, int tickets);
+
+// Removes and returns the job holding ticket number 'ticket' in [0, total)
+int tpool_take(TicketPool *t, int64_t ticket);
+
+static inline bool tpool_empty(const TicketPool *t) { return t->size == 0; }
+
+#endif
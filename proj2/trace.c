@@ -0,0 +1,135 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "trace.h"
+
+static int trace_arrival(const JobSource *src, int index) {
+    const Trace *t = src->ctx;
+    return t->rec[index].arrival;
+}
+
+static void trace_load(const JobSource *src, int index, JobSpec *dst) {
+    const Trace *t = src->ctx;
+    const TraceRecord *r = &t->rec[index];
+    dst->id = index + 1;
+    dst->name = (index < 26) ? ('A' + index) : '?';
+    dst->arrival_time = r->arrival;
+    dst->run_time = r->burst;
+    dst->priority = r->priority;
+}
+
+bool trace_open(Trace *t, const char *path) {
+    memset(t, 0, sizeof(Trace));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TraceHeader)) {
+        fprintf(stderr, "%s: not a trace file\n", path);
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "%s: mmap: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    const TraceHeader *h = map;
+    size_t body = st.st_size - sizeof(TraceHeader);
+    if (memcmp(h->magic, TRACE_MAGIC, 8) != 0 || h->record_size != sizeof(TraceRecord) ||
+        h->count > INT32_MAX || h->count * sizeof(TraceRecord) != body) {
+        fprintf(stderr, "%s: bad trace header\n", path);
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    // Records are consumed front to back, once per replay
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    t->map = map;
+    t->map_len = st.st_size;
+    t->rec = (const TraceRecord *)((const char *)map + sizeof(TraceHeader));
+    t->count = (int)h->count;
+    t->source = (JobSource){ .count = t->count, .arrival = trace_arrival, .load = trace_load, .ctx = t };
+    return true;
+}
+
+void trace_close(Trace *t) {
+    if (t->map) munmap(t->map, t->map_len);
+    memset(t, 0, sizeof(Trace));
+}
+
+bool trace_import_csv(const char *csv_path, const char *out_path) {
+    FILE *in = fopen(csv_path, "r");
+    if (!in) {
+        fprintf(stderr, "%s: %s\n", csv_path, strerror(errno));
+        return false;
+    }
+    FILE *out = fopen(out_path, "wb");
+    if (!out) {
+        fprintf(stderr, "%s: %s\n", out_path, strerror(errno));
+        fclose(in);
+        return false;
+    }
+
+    TraceHeader h = { .record_size = sizeof(TraceRecord) };
+    memcpy(h.magic, TRACE_MAGIC, 8);
+    fwrite(&h, sizeof(h), 1, out); // count is patched in at the end
+
+    char line[256];
+    long line_no = 0;
+    int32_t last_arrival = 0;
+    bool ok = true;
+
+    while (fgets(line, sizeof(line), in)) {
+        line_no++;
+        TraceRecord r;
+        if (sscanf(line, " %d , %d , %d", &r.arrival, &r.burst, &r.priority) != 3) {
+            if (line_no == 1) continue; // header row
+            if (strspn(line, " \t\r\n") == strlen(line)) continue; // blank
+            fprintf(stderr, "%s:%ld: expected arrival,burst,priority\n", csv_path, line_no);
+            ok = false;
+            break;
+        }
+        if (r.arrival < 0 || r.burst < 1) {
+            fprintf(stderr, "%s:%ld: arrival must be >= 0 and burst >= 1\n", csv_path, line_no);
+            ok = false;
+            break;
+        }
+        if (h.count > 0 && r.arrival < last_arrival) {
+            fprintf(stderr, "%s:%ld: rows must be sorted by arrival\n", csv_path, line_no);
+            ok = false;
+            break;
+        }
+        if (h.count == INT32_MAX) {
+            fprintf(stderr, "%s: too many jobs\n", csv_path);
+            ok = false;
+            break;
+        }
+        last_arrival = r.arrival;
+        fwrite(&r, sizeof(r), 1, out);
+        h.count++;
+    }
+
+    if (ok) {
+        fseek(out, 0, SEEK_SET);
+        fwrite(&h, sizeof(h), 1, out);
+    }
+    if (ferror(out)) {
+        fprintf(stderr, "%s: write error\n", out_path);
+        ok = false;
+    }
+    fclose(in);
+    fclose(out);
+    if (!ok) remove(out_path);
+    return ok;
+}
@@ -0,0 +1,44 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "scheduler.h"
+
+// --- Binary Job Traces ---
+// A trace is a fixed header followed by packed (arrival, burst, priority)
+// records sorted by arrival, in host byte order. Replay maps the file and
+// feeds records to the engine as jobs arrive, so nothing is parsed or copied
+// up front no matter how large the trace is.
+
+#define TRACE_MAGIC "SCHTRC01"
+
+typedef struct {
+    char magic[8];
+    uint32_t record_size;   // sizeof(TraceRecord), guards against layout drift
+    uint32_t reserved;
+    uint64_t count;
+} TraceHeader;
+
+typedef struct {
+    int32_t arrival;
+    int32_t burst;
+    int32_t priority;
+} TraceRecord;
+
+typedef struct {
+    void *map;
+    size_t map_len;
+    const TraceRecord *rec;
+    int count;
+    JobSource source;   // streams 'rec' into the engine
+} Trace;
+
+// Maps 'path' read-only; prints the reason and returns false on failure
+bool trace_open(Trace *t, const char *path);
+void trace_close(Trace *t);
+
+// Converts a CSV of arrival,burst,priority rows (optional header line) into
+// a binary trace. Rows must already be sorted by arrival.
+bool trace_import_csv(const char *csv_path, const char *out_path);
+
+#endif
@@ -1,15 +1,28 @@
+#define _GNU_SOURCE // syscall() for the futex, clock_gettime()
 #include "proj3.h"
+#include <limits.h>
+#include <linux/futex.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/syscall.h>
 #include <time.h>
+#include <unistd.h>
 
 // Global variables
+Config config = {
+    .shape = {DEFAULT_SECTIONS, DEFAULT_ROWS, DEFAULT_SEATS},
+    .num_type = {DEFAULT_H, DEFAULT_M, DEFAULT_L},
+    .minutes = DEFAULT_MINUTES,
+    .chart_every = 1,
+    .barrier_tree = true,
+};
 Venue venue;
 Barrier barrier_start;
 Barrier barrier_end;
-SellerArgs sellers[NUM_SELLERS];
+SellerArgs *sellers;
+int num_sellers;
 
 // ============================================================================
 // Statistics
@@ -27,7 +40,8 @@ static TypeStats stats_H = {0};
 static TypeStats stats_M = {0};
 static TypeStats stats_L = {0};
 
-static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Each seller counts on its own; the totals are folded after the join
+static TypeStats *seller_stats;
 
 static TypeStats *get_stats(char type) {
   if (type == 'H')
@@ -37,10 +51,16 @@ static TypeStats *get_stats(char type) {
   return &stats_L;
 }
 
-// Fixed composition in your initialize_sellers()
-#define NUM_H 1
-#define NUM_M 3
-#define NUM_L 6
+static void collect_stats() {
+  for (int i = 0; i < num_sellers; i++) {
+    TypeStats *ts = get_stats(sellers[i].seller_type);
+    ts->served += seller_stats[i].served;
+    ts->finished += seller_stats[i].finished;
+    ts->turned_away += seller_stats[i].turned_away;
+    ts->total_response_time += seller_stats[i].total_response_time;
+    ts->total_turnaround_time += seller_stats[i].total_turnaround_time;
+  }
+}
 
 static void print_type_report(const char *name, char type,
                               int num_sellers_of_type) {
@@ -59,14 +79,16 @@ static void print_type_report(const char *name, char type,
   // Throughput (customers per minute)
   // A) Assigned throughput: customers who were assigned a seat / started
   // service
-  double tp_assigned_type = (double)ts->served / (double)MAX_MINUTES;
+  double tp_assigned_type = (double)ts->served / (double)config.minutes;
   double tp_assigned_per_seller =
-      tp_assigned_type / (double)num_sellers_of_type;
+      num_sellers_of_type > 0 ? tp_assigned_type / (double)num_sellers_of_type
+                              : 0.0;
 
   // B) Finished throughput: customers who completed service (left)
-  double tp_finished_type = (double)ts->finished / (double)MAX_MINUTES;
+  double tp_finished_type = (double)ts->finished / (double)config.minutes;
   double tp_finished_per_seller =
-      tp_finished_type / (double)num_sellers_of_type;
+      num_sellers_of_type > 0 ? tp_finished_type / (double)num_sellers_of_type
+                              : 0.0;
 
   printf("\n[%s Sellers]\n", name);
   printf("  Served (assigned): %ld\n", ts->served);
@@ -79,13 +101,16 @@ static void print_type_report(const char *name, char type,
 
   printf("  Throughput Assigned (cust/min, type total): %.4f\n",
          tp_assigned_type);
-  printf("  Throughput Assigned per seller (cust/min/seller, avg): %.4f\n",
-         tp_assigned_per_seller);
+  // -sellers may leave a type with no sellers; it has no per-seller rate
+  if (num_sellers_of_type > 0)
+    printf("  Throughput Assigned per seller (cust/min/seller, avg): %.4f\n",
+           tp_assigned_per_seller);
 
   printf("  Throughput Finished (cust/min, type total): %.4f\n",
          tp_finished_type);
-  printf("  Throughput Finished per seller (cust/min/seller, avg): %.4f\n",
-         tp_finished_per_seller);
+  if (num_sellers_of_type > 0)
+    printf("  Throughput Finished per seller (cust/min/seller, avg): %.4f\n",
+           tp_finished_per_seller);
 }
 
 // ============================================================================
@@ -125,130 +150,407 @@ Customer *dequeue(Queue *q) {
 // Barrier Functions
 // ============================================================================
 
-void barrier_init(Barrier *b, int n) {
+// Builds the arrival tree bottom up: level 0 has one node per fan_in
+// threads, each level above one per fan_in nodes, up to a single root.
+// Without the tree, fan_in is n and that root is the only node. Wait
+// times are only measured when 'timed'.
+void barrier_init(Barrier *b, int n, bool tree, bool timed) {
+  int fan_in = tree ? BARRIER_FAN_IN : n;
+  int total = 0;
+  for (int m = n; m > 1 || total == 0; m = (m + fan_in - 1) / fan_in)
+    total += (m + fan_in - 1) / fan_in;
+
+  atomic_init(&b->sense, 0);
+  atomic_init(&b->sleepers, 0);
   b->limit = n;
-  b->count = 0;
-  b->crossing = 0;
-  pthread_mutex_init(&b->mutex, NULL);
-  pthread_cond_init(&b->cond, NULL);
-}
-
-void barrier_wait(Barrier *b) {
-  pthread_mutex_lock(&b->mutex);
-  int gen = b->crossing;
-  b->count++;
-  if (b->count >= b->limit) {
-    b->crossing++;
-    b->count = 0;
-    pthread_cond_broadcast(&b->cond);
-  } else {
-    while (gen == b->crossing) {
-      pthread_cond_wait(&b->cond, &b->mutex);
+  b->fan_in = fan_in;
+  // Spinning only helps if every thread can be on a CPU at once; otherwise
+  // it takes time from the threads still to arrive. The writer thread
+  // counts too: it sleeps on empty rings, but wakes to print each minute
+  // just as the sellers reach the barriers.
+  b->spin = n + 1 <= sysconf(_SC_NPROCESSORS_ONLN) ? BARRIER_SPIN : 0;
+  b->nodes = aligned_alloc(_Alignof(BarrierNode), sizeof(BarrierNode) * total);
+  b->waits = timed ? aligned_alloc(_Alignof(BarrierWait), sizeof(BarrierWait) * n)
+                  : NULL;
+  if (!b->nodes || (timed && !b->waits)) {
+    perror("barrier_init");
+    exit(1);
+  }
+  if (timed)
+    memset(b->waits, 0, sizeof(BarrierWait) * n);
+
+  int start = 0, prev_start = 0, m = n; // m = arrivals into this level
+  do {
+    int count = (m + fan_in - 1) / fan_in;
+    for (int j = 0; j < count; j++) {
+      BarrierNode *node = &b->nodes[start + j];
+      node->children = m - j * fan_in < fan_in ? m - j * fan_in : fan_in;
+      node->parent = -1;
+      atomic_init(&node->count, node->children);
+    }
+    if (start > 0) {
+      for (int c = 0; c < m; c++)
+        b->nodes[prev_start + c].parent = start + c / fan_in;
     }
+    prev_start = start;
+    start += count;
+    m = count;
+  } while (m > 1);
+}
+
+static void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+// Waits until sense moves off 'sense': polls it b->spin times, which
+// covers short minutes without a syscall, then sleeps on it as a futex
+static void barrier_sleep(Barrier *b, int sense) {
+  for (int i = 0; i < b->spin; i++) {
+    if (atomic_load_explicit(&b->sense, memory_order_acquire) != sense)
+      return;
+    cpu_relax();
   }
-  pthread_mutex_unlock(&b->mutex);
+  atomic_fetch_add(&b->sleepers, 1);
+  while (atomic_load(&b->sense) == sense)
+    syscall(SYS_futex, (int *)&b->sense, FUTEX_WAIT_PRIVATE, sense, NULL, NULL, 0);
+  atomic_fetch_sub(&b->sleepers, 1);
+}
+
+// Thread 'id' (0..limit-1) arrives. It decrements its leaf; the last child
+// of a node resets it and climbs to the parent, so each counter is shared
+// by at most fan_in threads. The last arrival at the root flips sense,
+// which releases everyone; a wake call is made only if someone sleeps.
+// sense can be read before arriving because it cannot flip until this
+// thread has arrived.
+void barrier_wait(Barrier *b, int id) {
+  struct timespec t0, t1;
+  if (b->waits)
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  int sense = atomic_load_explicit(&b->sense, memory_order_relaxed);
+  BarrierNode *node = &b->nodes[id / b->fan_in];
+  for (;;) {
+    if (atomic_fetch_sub_explicit(&node->count, 1, memory_order_acq_rel) != 1) {
+      barrier_sleep(b, sense);
+      break;
+    }
+    atomic_store_explicit(&node->count, node->children, memory_order_relaxed);
+    if (node->parent < 0) {
+      atomic_store(&b->sense, !sense);
+      if (atomic_load(&b->sleepers) > 0)
+        syscall(SYS_futex, (int *)&b->sense, FUTEX_WAKE_PRIVATE, b->limit, NULL,
+                NULL, 0);
+      break;
+    }
+    node = &b->nodes[node->parent];
+  }
+  if (b->waits == NULL)
+    return;
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  long long ns = (t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec);
+  BarrierWait *w = &b->waits[id];
+  w->total_ns += ns;
+  if (ns > w->max_ns)
+    w->max_ns = ns;
+}
+
+// Per-seller time at both barriers, in ms: the total and the longest
+// single wait
+static void print_barrier_waits() {
+  printf("\n[Barrier Waits] (ms, total / longest)\n");
+  printf("  %-8s %20s %20s\n", "Seller", "barrier_start", "barrier_end");
+  double sum[2] = {0, 0};
+  for (int i = 0; i < num_sellers; i++) {
+    const BarrierWait *ws = &barrier_start.waits[i];
+    const BarrierWait *we = &barrier_end.waits[i];
+    char name[16];
+    snprintf(name, sizeof(name), "%c%d", sellers[i].seller_type, i + 1);
+    printf("  %-8s %11.3f /%7.3f %11.3f /%7.3f\n", name, ws->total_ns / 1e6,
+           ws->max_ns / 1e6, we->total_ns / 1e6, we->max_ns / 1e6);
+    sum[0] += ws->total_ns / 1e6;
+    sum[1] += we->total_ns / 1e6;
+  }
+  printf("  %-8s %11.3f %20.3f\n", "Total", sum[0], sum[1]);
 }
 
 // ============================================================================
 // Venue Functions
 // ============================================================================
 
-void venue_init() {
-  venue.seats_sold = 0;
-  pthread_mutex_init(&venue.mutex, NULL);
-  for (int i = 0; i < 10; i++) {
-    for (int j = 0; j < 10; j++) {
-      strcpy(venue.seats[i][j], "-");
-    }
+// Sections, and rows within a section, in each seller type's preference
+// order; seats within a row go left to right
+static int *section_order[3];
+static int *row_order[3];
+
+static int type_index(char type) {
+  if (type == 'H')
+    return 0;
+  if (type == 'M')
+    return 1;
+  return 2;
+}
+
+// 0..n-1 as type 'type' prefers them: H front to back, M middle outward
+// (4, 5, 3, 6, ... for 10), L back to front
+static int *preference_order(int n, int type) {
+  int *order = malloc(sizeof(int) * n);
+  for (int k = 0; k < n; k++) {
+    if (type == 0)
+      order[k] = k;
+    else if (type == 1)
+      order[k] = (n - 1) / 2 + (k % 2 ? (k + 1) / 2 : -(k / 2));
+    else
+      order[k] = n - 1 - k;
   }
+  return order;
 }
 
-int sell_seat(char seller_type, int customer_id, int seller_id) {
-  pthread_mutex_lock(&venue.mutex);
+void venue_init(const VenueShape *shape) {
+  venue.shape = *shape;
+  venue.row_words = (shape->seats + 63) / 64;
+  size_t rows = (size_t)shape->sections * shape->rows;
+  size_t words = rows * venue.row_words;
+  venue.row_free = malloc(sizeof(atomic_ullong) * words);
+  venue.sections = aligned_alloc(_Alignof(SectionSummary),
+                                 sizeof(SectionSummary) * shape->sections);
+  if (!venue.row_free || !venue.sections) {
+    perror("venue_init");
+    exit(1);
+  }
 
-  if (venue.seats_sold >= 100) {
-    pthread_mutex_unlock(&venue.mutex);
-    return 0;
+  for (size_t w = 0; w < words; w++) {
+    int first = (int)(w % venue.row_words) * 64;
+    int left = shape->seats - first;
+    atomic_init(&venue.row_free[w], left >= 64 ? ~0ull : (1ull << left) - 1);
+  }
+  for (int sec = 0; sec < shape->sections; sec++) {
+    atomic_init(&venue.sections[sec].free, shape->rows * shape->seats);
   }
+  for (int t = 0; t < 3; t++) {
+    section_order[t] = preference_order(shape->sections, t);
+    row_order[t] = preference_order(shape->rows, t);
+  }
+}
 
-  int row = -1, col = -1;
+// Seats sold so far, from the section counts
+int venue_sold() {
+  int sold = 0;
+  for (int sec = 0; sec < venue.shape.sections; sec++) {
+    sold += venue.shape.rows * venue.shape.seats -
+            atomic_load_explicit(&venue.sections[sec].free, memory_order_relaxed);
+  }
+  return sold;
+}
 
-  if (seller_type == 'H') {
-    // Front to back
-    for (int i = 0; i < 10 && row == -1; i++) {
-      for (int j = 0; j < 10 && row == -1; j++) {
-        if (strcmp(venue.seats[i][j], "-") == 0) {
-          row = i;
-          col = j;
-        }
-      }
-    }
-  } else if (seller_type == 'M') {
-    // Middle outward
-    int order[] = {4, 5, 3, 6, 2, 7, 1, 8, 0, 9};
-    for (int k = 0; k < 10 && row == -1; k++) {
-      for (int j = 0; j < 10 && row == -1; j++) {
-        if (strcmp(venue.seats[order[k]][j], "-") == 0) {
-          row = order[k];
-          col = j;
-        }
-      }
-    }
-  } else {
-    // Back to front
-    for (int i = 9; i >= 0 && row == -1; i--) {
-      for (int j = 0; j < 10 && row == -1; j++) {
-        if (strcmp(venue.seats[i][j], "-") == 0) {
-          row = i;
-          col = j;
-        }
-      }
+// Takes the lowest free seat of global row 'row', -1 if it is full. A failed
+// CAS reloads the word, so this retries until the row runs out.
+static int claim_in_row(int row) {
+  atomic_ullong *word = &venue.row_free[(size_t)row * venue.row_words];
+  for (int w = 0; w < venue.row_words; w++) {
+    unsigned long long mask = atomic_load_explicit(&word[w], memory_order_relaxed);
+    while (mask != 0) {
+      int bit = __builtin_ctzll(mask);
+      if (atomic_compare_exchange_weak_explicit(&word[w], &mask,
+                                                mask & ~(1ull << bit),
+                                                memory_order_acquire,
+                                                memory_order_relaxed))
+        return w * 64 + bit;
     }
   }
+  return -1;
+}
 
-  if (row != -1) {
-    char seat_label[10];
-    sprintf(seat_label, "%c%d%02d", seller_type, seller_id + 1, customer_id);
-    strcpy(venue.seats[row][col], seat_label);
-    venue.seats_sold++;
+// Claims the first free seat in the seller's preference order without a
+// lock and returns its index in [section][row][seat] order, -1 if none is
+// left. The seat's record is kept only in the writer's chart copy. A
+// section whose count is 0 is skipped in O(1); inside a section the seller
+// takes the lowest set bit of the first row bitmap that is not empty.
+// Seats are never given back, so the seller's cursors only move forward: a
+// section or row it has seen full is never looked at again.
+int sell_seat(SellerArgs *s) {
+  int type = type_index(s->seller_type);
+  const VenueShape *shape = &venue.shape;
+
+  for (; s->cursor_section < shape->sections; s->cursor_section++, s->cursor_row = 0) {
+    int sec = section_order[type][s->cursor_section];
+    if (atomic_load_explicit(&venue.sections[sec].free, memory_order_relaxed) == 0)
+      continue;
+
+    for (; s->cursor_row < shape->rows; s->cursor_row++) {
+      int row = sec * shape->rows + row_order[type][s->cursor_row];
+      int col = claim_in_row(row);
+      if (col < 0)
+        continue;
+      atomic_fetch_sub_explicit(&venue.sections[sec].free, 1, memory_order_relaxed);
+      return row * shape->seats + col;
+    }
   }
+  return -1;
+}
 
-  pthread_mutex_unlock(&venue.mutex);
-  return (row != -1);
+// Chart label of a seat: "-", or type, seller and customer as in "M301"
+static void seat_label(SeatRecord rec, char *buf, size_t len) {
+  if (rec == SEAT_FREE)
+    snprintf(buf, len, "-");
+  else
+    snprintf(buf, len, "%c%u%02u", "?HML"[SEAT_TYPE(rec) & 3],
+             (unsigned)SEAT_SELLER(rec), (unsigned)SEAT_CUSTOMER(rec));
 }
 
-void print_chart() {
-  pthread_mutex_lock(&venue.mutex);
-  printf("Seating Chart:\n");
-  printf("      ");
-  for (int j = 0; j < 10; j++) {
-    printf("%6d", j + 1);
-  }
-  printf("\n");
+static void print_chart_border(int seats) {
   printf("    +");
-  for (int j = 0; j < 10; j++) {
+  for (int j = 0; j < seats; j++) {
     printf("------");
   }
   printf("+\n");
-  for (int i = 0; i < 10; i++) {
-    printf("%4d|", i + 1);
-    for (int j = 0; j < 10; j++) {
-      printf("%6s", venue.seats[i][j]);
+}
+
+// Prints a venue-shaped array of seat records: the writer's own copy, so
+// sellers may keep selling meanwhile. With several sections each gets its
+// own block, rows numbered within the section.
+void print_chart(const SeatRecord *seats) {
+  const VenueShape *shape = &venue.shape;
+  printf("Seating Chart:\n");
+  for (int sec = 0; sec < shape->sections; sec++) {
+    if (shape->sections > 1)
+      printf("Section %d:\n", sec + 1);
+    printf("      ");
+    for (int j = 0; j < shape->seats; j++) {
+      printf("%6d", j + 1);
     }
-    printf(" |\n");
+    printf("\n");
+    print_chart_border(shape->seats);
+    for (int i = 0; i < shape->rows; i++) {
+      const SeatRecord *row = &seats[((size_t)sec * shape->rows + i) * shape->seats];
+      printf("%4d|", i + 1);
+      for (int j = 0; j < shape->seats; j++) {
+        char label[16];
+        seat_label(row[j], label, sizeof(label));
+        printf("%6s", label);
+      }
+      printf(" |\n");
+    }
+    print_chart_border(shape->seats);
   }
-  printf("    +");
-  for (int j = 0; j < 10; j++) {
-    printf("------");
+}
+
+// ============================================================================
+// Event Log
+// ============================================================================
+
+// Sellers never format text or touch stdout. Each appends LogEvents to its
+// own ring; one writer thread drains the rings minute by minute in seller
+// order and prints. Sellers wait only if their ring is full, i.e. the
+// writer is LOG_RING_SIZE events behind.
+//
+// Neither side polls: the one that has to wait raises its flag, checks the
+// ring again and sleeps on the other side's index. The other side stores
+// its index, then checks the flag and wakes it. Both steps are seq_cst, so
+// one of them always sees the other's store.
+
+static void futex_wait(atomic_uint *addr, unsigned val) {
+  syscall(SYS_futex, (unsigned *)addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+static void futex_wake(atomic_uint *addr) {
+  syscall(SYS_futex, (unsigned *)addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+static void log_ring_init(LogRing *ring) {
+  atomic_init(&ring->head, 0);
+  atomic_init(&ring->tail, 0);
+  atomic_init(&ring->writer_waiting, 0);
+  atomic_init(&ring->seller_waiting, 0);
+  ring->events = malloc(sizeof(LogEvent) * LOG_RING_SIZE);
+  if (ring->events == NULL) {
+    perror("malloc");
+    exit(1);
   }
-  printf("+\n");
-  pthread_mutex_unlock(&venue.mutex);
 }
 
-void log_msg(const char *msg) {
-  pthread_mutex_lock(&venue.mutex);
-  printf("%s\n", msg);
-  pthread_mutex_unlock(&venue.mutex);
+void log_event(SellerArgs *s, int kind, int minute, int customer, int seat) {
+  LogRing *ring = &s->log;
+  unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  while (tail - atomic_load_explicit(&ring->head, memory_order_acquire) ==
+         LOG_RING_SIZE) {
+    atomic_store(&ring->seller_waiting, 1);
+    unsigned head = atomic_load(&ring->head);
+    if (tail - head == LOG_RING_SIZE)
+      futex_wait(&ring->head, head);
+    atomic_store(&ring->seller_waiting, 0);
+  }
+
+  ring->events[tail & (LOG_RING_SIZE - 1)] = (LogEvent){
+      .minute = minute, .seat = seat, .customer = customer, .kind = kind};
+  atomic_store(&ring->tail, tail + 1);
+  if (atomic_load(&ring->writer_waiting))
+    futex_wake(&ring->tail);
+}
+
+// Next event of one seller, waiting for it if the ring is empty
+static LogEvent log_pop(LogRing *ring) {
+  unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  while (atomic_load_explicit(&ring->tail, memory_order_acquire) == head) {
+    atomic_store(&ring->writer_waiting, 1);
+    if (atomic_load(&ring->tail) == head)
+      futex_wait(&ring->tail, head);
+    atomic_store(&ring->writer_waiting, 0);
+  }
+
+  LogEvent ev = ring->events[head & (LOG_RING_SIZE - 1)];
+  atomic_store(&ring->head, head + 1);
+  if (atomic_load(&ring->seller_waiting))
+    futex_wake(&ring->head);
+  return ev;
+}
+
+static const char *const event_text[] = {
+    [EV_ARRIVE] = "arrives.",
+    [EV_ASSIGN] = "assigned seat.",
+    [EV_TURNED_AWAY] = "turned away (Sold Out).",
+    [EV_LEAVE] = "leaves.",
+};
+
+// Writer thread: prints each minute's events in seller order, as one batch
+// through a fully buffered stdout. The chart is drawn from the writer's own
+// copy of the seats, rebuilt from EV_ASSIGN events, after every
+// config.chart_every sales and departures (at the end of that minute).
+static void *writer_thread(void *arg) {
+  (void)arg;
+  size_t nseats = (size_t)venue.shape.sections * venue.shape.rows * venue.shape.seats;
+  SeatRecord *chart = calloc(nseats, sizeof(SeatRecord));
+  if (chart == NULL) {
+    perror("calloc");
+    exit(1);
+  }
+  int pending = 0; // sales and departures since the last chart
+
+  for (int minute = 0; minute < config.minutes; minute++) {
+    for (int i = 0; i < num_sellers; i++) {
+      SellerArgs *s = &sellers[i];
+      for (LogEvent ev = log_pop(&s->log); ev.kind != EV_MINUTE_END;
+           ev = log_pop(&s->log)) {
+        printf("[%02d:%02d] Seller %c%d: Customer %02d %s\n", ev.minute / 60,
+               ev.minute % 60, s->seller_type, s->seller_id + 1, ev.customer,
+               event_text[ev.kind]);
+        if (ev.kind == EV_ASSIGN)
+          chart[ev.seat] = SEAT_PACK(type_index(s->seller_type) + 1,
+                                     s->seller_id + 1, ev.customer);
+        if (ev.kind == EV_ASSIGN || ev.kind == EV_LEAVE)
+          pending++;
+      }
+    }
+    if (config.chart_every > 0 && pending >= config.chart_every) {
+      print_chart(chart);
+      pending = 0;
+    }
+  }
+  fflush(stdout);
+  free(chart);
+  return NULL;
 }
 
 // ============================================================================
@@ -269,7 +571,7 @@ void create_buyers_for_seller(Queue *q, char seller_type, int N) {
   for (int i = 0; i < N; i++) {
     Customer *c = malloc(sizeof(Customer));
     c->id = i + 1;
-    c->arrival_time = rand() % MAX_MINUTES;
+    c->arrival_time = rand() % config.minutes;
     c->service_time = get_service_time(seller_type);
     c->start_time = -1;
     c->finish_time = -1;
@@ -283,52 +585,35 @@ void *seller_thread(void *arg) {
   SellerArgs *s = (SellerArgs *)arg;
   Customer *current = NULL;
   int service_timer = 0;
+  TypeStats *ts = &seller_stats[s->seller_id];
 
-  for (int minute = 0; minute < MAX_MINUTES; minute++) {
-    barrier_wait(&barrier_start);
+  for (int minute = 0; minute < config.minutes; minute++) {
+    barrier_wait(&barrier_start, s->seller_id);
 
     // Try to serve new customer
     if (current == NULL && s->queue->front != NULL) {
       Customer *c = s->queue->front;
       if (c->arrival_time <= minute) {
-        char arrival_msg[100];
-        sprintf(arrival_msg, "[00:%02d] Seller %c%d: Customer %02d arrives.",
-                minute, s->seller_type, s->seller_id + 1, c->id);
-        log_msg(arrival_msg);
-        if (sell_seat(s->seller_type, c->id, s->seller_id)) {
+        log_event(s, EV_ARRIVE, minute, c->id, 0);
+        int seat = sell_seat(s);
+        if (seat >= 0) {
           current = dequeue(s->queue);
           current->start_time = minute;
           service_timer = current->service_time;
 
           // Stats: served count + response time
           long resp = (long)minute - (long)current->arrival_time;
-
-          pthread_mutex_lock(&stats_mutex);
-          TypeStats *ts = get_stats(s->seller_type);
           ts->served++;
           ts->total_response_time += resp;
-          pthread_mutex_unlock(&stats_mutex);
 
-          char msg[100];
-          sprintf(msg, "[00:%02d] Seller %c%d: Customer %02d assigned seat.",
-                  minute, s->seller_type, s->seller_id + 1, current->id);
-          log_msg(msg);
-          print_chart();
+          log_event(s, EV_ASSIGN, minute, current->id, seat);
         } else {
           Customer *rejected = dequeue(s->queue);
 
           // Stats: turned away count
-          pthread_mutex_lock(&stats_mutex);
-          TypeStats *ts = get_stats(s->seller_type);
           ts->turned_away++;
-          pthread_mutex_unlock(&stats_mutex);
-
-          char msg[100];
-          sprintf(
-              msg,
-              "[00:%02d] Seller %c%d: Customer %02d turned away (Sold Out).",
-              minute, s->seller_type, s->seller_id + 1, rejected->id);
-          log_msg(msg);
+
+          log_event(s, EV_TURNED_AWAY, minute, rejected->id, 0);
           free(rejected);
         }
       }
@@ -342,53 +627,39 @@ void *seller_thread(void *arg) {
 
         // Stats: turnaround time
         long tat = (long)current->finish_time - (long)current->arrival_time;
-
-        pthread_mutex_lock(&stats_mutex);
-        TypeStats *ts = get_stats(s->seller_type);
         ts->finished++;
         ts->total_turnaround_time += tat;
-        pthread_mutex_unlock(&stats_mutex);
 
-        char msg[100];
-        sprintf(msg, "[00:%02d] Seller %c%d: Customer %02d leaves.", minute,
-                s->seller_type, s->seller_id + 1, current->id);
-        log_msg(msg);
-        print_chart();
+        log_event(s, EV_LEAVE, minute, current->id, 0);
         free(current);
         current = NULL;
       }
     }
 
-    barrier_wait(&barrier_end);
+    log_event(s, EV_MINUTE_END, minute, 0, 0);
+    barrier_wait(&barrier_end, s->seller_id);
   }
 
   return NULL;
 }
 
-// Initialize sellers
-void initialize_sellers(SellerArgs sellers[], int N) {
-  int i;
-
-  // H1
-  sellers[0].seller_id = 0;
-  sellers[0].seller_type = 'H';
-  sellers[0].queue = create_queue();
-  create_buyers_for_seller(sellers[0].queue, 'H', N);
-
-  // M1–M3
-  for (i = 1; i <= 3; i++) {
-    sellers[i].seller_id = i;
-    sellers[i].seller_type = 'M';
-    sellers[i].queue = create_queue();
-    create_buyers_for_seller(sellers[i].queue, 'M', N);
-  }
-
-  // L1–L6
-  for (i = 4; i < 10; i++) {
-    sellers[i].seller_id = i;
-    sellers[i].seller_type = 'L';
-    sellers[i].queue = create_queue();
-    create_buyers_for_seller(sellers[i].queue, 'L', N);
+// Initialize sellers: the H sellers first, then M, then L
+void initialize_sellers(int N) {
+  num_sellers = config.num_type[0] + config.num_type[1] + config.num_type[2];
+  // SellerArgs is cache-line aligned for its log ring
+  sellers = aligned_alloc(_Alignof(SellerArgs), sizeof(SellerArgs) * num_sellers);
+  memset(sellers, 0, sizeof(SellerArgs) * num_sellers);
+  seller_stats = calloc(num_sellers, sizeof(TypeStats));
+
+  int i = 0;
+  for (int t = 0; t < 3; t++) {
+    for (int k = 0; k < config.num_type[t]; k++, i++) {
+      sellers[i].seller_id = i;
+      sellers[i].seller_type = "HML"[t];
+      sellers[i].queue = create_queue();
+      log_ring_init(&sellers[i].log);
+      create_buyers_for_seller(sellers[i].queue, "HML"[t], N);
+    }
   }
 }
 
@@ -396,36 +667,84 @@ void initialize_sellers(SellerArgs sellers[], int N) {
 // Main
 // ============================================================================
 
+static void usage(const char *prog) {
+  printf("Usage: %s <N> [-venue SECTIONS:ROWS:SEATS] [-sellers H:M:L] "
+         "[-minutes M] [-chart K] [-barrier central|tree] [-waits]\n",
+         prog);
+  exit(1);
+}
+
+// "A:B:C" into three positive ints
+static int parse_triple(const char *arg, int out[3]) {
+  char end;
+  return sscanf(arg, "%d:%d:%d%c", &out[0], &out[1], &out[2], &end) == 3;
+}
+
 int main(int argc, char *argv[]) {
-  if (argc != 2) {
-    printf("Usage: %s <N>\n", argv[0]);
-    exit(1);
-  }
+  if (argc < 2)
+    usage(argv[0]);
 
   srand(time(NULL));
   int N = atoi(argv[1]);
-
-  // Initialize venue and barriers
-  venue_init();
-  barrier_init(&barrier_start, NUM_SELLERS);
-  barrier_init(&barrier_end, NUM_SELLERS);
-
-  // Initialize sellers
-  initialize_sellers(sellers, N);
-
-  // Create threads
-  pthread_t threads[NUM_SELLERS];
-  for (int i = 0; i < NUM_SELLERS; i++) {
+  for (int i = 2; i < argc; i++) {
+    int v[3];
+    // Seat indices are ints, so the venue must have at most INT_MAX seats
+    if (strcmp(argv[i], "-venue") == 0 && i + 1 < argc &&
+        parse_triple(argv[++i], v) && v[0] > 0 && v[1] > 0 && v[2] > 0 &&
+        (long long)v[0] * v[1] * v[2] <= INT_MAX) {
+      config.shape = (VenueShape){v[0], v[1], v[2]};
+    } else if (strcmp(argv[i], "-sellers") == 0 && i + 1 < argc &&
+               parse_triple(argv[++i], v) && v[0] >= 0 && v[1] >= 0 &&
+               v[2] >= 0 && v[0] + v[1] + v[2] > 0) {
+      memcpy(config.num_type, v, sizeof(v));
+    } else if (strcmp(argv[i], "-minutes") == 0 && i + 1 < argc &&
+               (config.minutes = atoi(argv[++i])) > 0) {
+    } else if (strcmp(argv[i], "-chart") == 0 && i + 1 < argc &&
+               (config.chart_every = atoi(argv[++i])) >= 0) {
+    } else if (strcmp(argv[i], "-barrier") == 0 && i + 1 < argc &&
+               (strcmp(argv[i + 1], "central") == 0 ||
+                strcmp(argv[i + 1], "tree") == 0)) {
+      config.barrier_tree = strcmp(argv[++i], "tree") == 0;
+    } else if (strcmp(argv[i], "-waits") == 0) {
+      config.report_waits = true;
+    } else {
+      usage(argv[0]);
+    }
+  }
+  // Seat records hold 12-bit seller and 16-bit customer numbers
+  if (N < 0 || N > MAX_CUSTOMER_ID ||
+      config.num_type[0] + config.num_type[1] + config.num_type[2] > MAX_SELLER_ID)
+    usage(argv[0]);
+  config.customers = N;
+
+  // Initialize venue and sellers, then the barriers for all of them
+  venue_init(&config.shape);
+  initialize_sellers(N);
+  barrier_init(&barrier_start, num_sellers, config.barrier_tree,
+               config.report_waits);
+  barrier_init(&barrier_end, num_sellers, config.barrier_tree,
+               config.report_waits);
+
+  // Create threads: the writer, then the sellers. Only the writer prints
+  // until all of them are joined.
+  static char stdout_buf[1 << 16];
+  setvbuf(stdout, stdout_buf, _IOFBF, sizeof(stdout_buf));
+  pthread_t writer;
+  pthread_create(&writer, NULL, writer_thread, NULL);
+  pthread_t *threads = malloc(sizeof(pthread_t) * num_sellers);
+  for (int i = 0; i < num_sellers; i++) {
     pthread_create(&threads[i], NULL, seller_thread, &sellers[i]);
   }
 
   // Wait for threads
-  for (int i = 0; i < NUM_SELLERS; i++) {
+  for (int i = 0; i < num_sellers; i++) {
     pthread_join(threads[i], NULL);
   }
+  pthread_join(writer, NULL);
+  collect_stats();
 
   // Final report
-  // - Total seats sold (from venue.seats_sold)
+  // - Total seats sold (from the venue's section counts)
   // - Total customers who completed service (left)
   // - Total customers turned away (sum from all sellers)
   // - Average response time (total response time / customers served)
@@ -435,12 +754,12 @@ int main(int argc, char *argv[]) {
 
   // Final report (per seller type)
   printf("\n==================== Final Report ====================\n");
-  printf("Total Seats Sold: %d\n", venue.seats_sold);
+  printf("Total Seats Sold: %d\n", venue_sold());
 
   // Per type stats (H/M/L)
-  print_type_report("High", 'H', NUM_H);
-  print_type_report("Medium", 'M', NUM_M);
-  print_type_report("Low", 'L', NUM_L);
+  print_type_report("High", 'H', config.num_type[0]);
+  print_type_report("Medium", 'M', config.num_type[1]);
+  print_type_report("Low", 'L', config.num_type[2]);
 
   // Overall totals (all types combined)
   long total_served = stats_H.served + stats_M.served + stats_L.served;
@@ -459,8 +778,8 @@ int main(int argc, char *argv[]) {
   double overall_avg_tat =
       (total_finished > 0) ? ((double)total_tat / (double)total_finished) : 0.0;
 
-  double overall_tp_assigned = (double)total_served / (double)MAX_MINUTES;
-  double overall_tp_finished = (double)total_finished / (double)MAX_MINUTES;
+  double overall_tp_assigned = (double)total_served / (double)config.minutes;
+  double overall_tp_finished = (double)total_finished / (double)config.minutes;
 
   printf("\n[Overall]\n");
   printf("  Served (assigned): %ld\n", total_served);
@@ -473,6 +792,8 @@ int main(int argc, char *argv[]) {
          overall_tp_assigned);
   printf("  Throughput Finished (cust/min, total): %.4f\n",
          overall_tp_finished);
+  if (config.report_waits)
+    print_barrier_waits();
 
   printf("======================================================\n");
 
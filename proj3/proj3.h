@@ -2,9 +2,19 @@
 #define PROJ3_H
 
 #include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
-#define NUM_SELLERS 10
-#define MAX_MINUTES 60
+// Defaults: the original 10x10 hall, 1 H + 3 M + 6 L sellers, one hour
+#define DEFAULT_SECTIONS 1
+#define DEFAULT_ROWS 10
+#define DEFAULT_SEATS 10
+#define DEFAULT_H 1
+#define DEFAULT_M 3
+#define DEFAULT_L 6
+#define DEFAULT_MINUTES 60
 
 // Customer structure (teammate's design)
 typedef struct Customer {
@@ -23,33 +33,133 @@ typedef struct {
     int size;
 } Queue;
 
+// What a seller did; the writer thread turns these into text
+typedef enum {
+    EV_ARRIVE,
+    EV_ASSIGN,      // seat = index of the seat sold
+    EV_TURNED_AWAY,
+    EV_LEAVE,
+    EV_MINUTE_END,  // the seller has logged everything for this minute
+} EventKind;
+
+// One fixed-size binary log record; the seller is implied by the ring
+typedef struct {
+    int32_t minute;
+    uint32_t seat;
+    uint16_t customer;
+    uint8_t kind;
+} LogEvent;
+
+#define LOG_RING_SIZE 1024  // events per seller, a power of two
+
+// Single-producer single-consumer ring: the seller pushes at tail, the
+// writer thread pops at head. Each index sits on its own cache line with
+// the flag of the side that sleeps on the other's index as a futex.
+typedef struct {
+    _Alignas(64) atomic_uint head;
+    atomic_int writer_waiting;  // the writer sleeps on tail (ring empty)
+    _Alignas(64) atomic_uint tail;
+    atomic_int seller_waiting;  // the seller sleeps on head (ring full)
+    LogEvent *events;   // [LOG_RING_SIZE]
+} LogRing;
+
 // Seller Data Structure (teammate's design)
 typedef struct {
     int seller_id;
     char seller_type;   // 'H', 'M', 'L'
     Queue *queue;
+    int cursor_section; // position in its type's section order; all before it are full
+    int cursor_row;     // position in its type's row order within that section
+    LogRing log;
 } SellerArgs;
 
-// Venue structure
+// A sold seat packed into 32 bits: seller type (1-3 = H/M/L) in the top 4,
+// seller id + 1 in the next 12, customer id in the low 16. 0 = free.
+typedef uint32_t SeatRecord;
+
+#define SEAT_FREE 0u
+#define SEAT_PACK(type, seller, customer) \
+    (((uint32_t)(type) << 28) | (((uint32_t)(seller) & 0xfff) << 16) | ((uint32_t)(customer) & 0xffff))
+#define SEAT_TYPE(rec) ((rec) >> 28)
+#define SEAT_SELLER(rec) (((rec) >> 16) & 0xfff)
+#define SEAT_CUSTOMER(rec) ((rec) & 0xffff)
+
+#define MAX_SELLER_ID 0xfff
+#define MAX_CUSTOMER_ID 0xffff
+
+// Venue geometry: sections front (0) to back, each with the same rows
+// (front to back) of the same number of seats
+typedef struct {
+    int sections;
+    int rows;           // per section
+    int seats;          // per row
+} VenueShape;
+
+// Top level of the free-seat summary, one cache line per section so
+// sellers working in different sections never share one
+typedef struct {
+    _Alignas(64) atomic_int free;   // seats left; 0 lets a search skip the section
+} SectionSummary;
+
+// Venue structure: a free-seat summary of section counts over per-row
+// bitmaps (bit set = seat free). A seat is claimed by clearing its bit
+// with CAS. Who holds a seat is only in the writer's chart copy, rebuilt
+// from EV_ASSIGN events. There is no global lock or counter: a venue is
+// sold out once every count is 0.
 typedef struct {
-    char seats[10][10][10];
-    int seats_sold;
-    pthread_mutex_t mutex;
+    VenueShape shape;
+    int row_words;              // 64-bit bitmap words per row
+    atomic_ullong *row_free;    // [section][row][row_words]
+    SectionSummary *sections;
 } Venue;
 
-// Barrier structure
+// Run configuration, from the command line
+typedef struct {
+    VenueShape shape;
+    int num_type[3];    // H, M, L sellers
+    int minutes;
+    int customers;      // per seller
+    int chart_every;    // print the chart after this many sales and departures; 0 = never
+    bool barrier_tree;  // fan-in BARRIER_FAN_IN arrival tree instead of one counter
+    bool report_waits;  // print each seller's barrier wait times
+} Config;
+
+#define BARRIER_FAN_IN 4     // arrivals per tree node
+#define BARRIER_SPIN 2000     // polls of the sense word before sleeping
+
+// One node of the arrival tree; the last of its children to arrive goes on
+// to the parent
+typedef struct {
+    _Alignas(64) atomic_int count;  // children still to arrive this crossing
+    int children;
+    int parent;         // -1 at the root
+} BarrierNode;
+
+// Time one thread spent waiting at a barrier, on its own cache line
+typedef struct {
+    _Alignas(64) long long total_ns;
+    long long max_ns;
+} BarrierWait;
+
+// Sense-reversing barrier. Threads arrive up a combining tree (one node of
+// all threads when tree is off); the last arrival at the root flips sense.
+// Waiters spin on sense, then sleep on it as a futex.
 typedef struct {
-    pthread_mutex_t mutex;
-    pthread_cond_t cond;
-    int count;
-    int crossing;
+    _Alignas(64) atomic_int sense;
+    atomic_int sleepers;    // threads in futex_wait; 0 skips the wake call
     int limit;
+    int fan_in;             // thread i arrives at node i / fan_in
+    int spin;               // BARRIER_SPIN, or 0 if sellers + writer exceed the CPUs
+    BarrierNode *nodes;     // leaves first, root last
+    BarrierWait *waits;     // [limit], NULL unless wait times are measured
 } Barrier;
 
 // Global variables
+extern Config config;
 extern Venue venue;
 extern Barrier barrier_start;
 extern Barrier barrier_end;
-extern SellerArgs sellers[NUM_SELLERS];
+extern SellerArgs *sellers;
+extern int num_sellers;
 
 #endif